@@ -133,6 +133,66 @@ extern int malloc_trim _PARAMS ((size_t));
 extern int _malloc_trim_r _PARAMS ((struct _reent *, size_t));
 #endif
 
+extern int malloc_walk _PARAMS ((int (*) (_PTR, size_t, int, _PTR), _PTR));
+#ifdef __CYGWIN__
+#undef _malloc_walk_r
+#define _malloc_walk_r(r, f, a) malloc_walk (f, a)
+#else
+extern int _malloc_walk_r _PARAMS ((struct _reent *,
+				    int (*) (_PTR, size_t, int, _PTR), _PTR));
+#endif
+
+extern int malloc_add_region _PARAMS ((_PTR, size_t));
+#ifdef __CYGWIN__
+#undef _malloc_add_region_r
+#define _malloc_add_region_r(r, p, s) malloc_add_region (p, s)
+#else
+extern int _malloc_add_region_r _PARAMS ((struct _reent *, _PTR, size_t));
+#endif
+
+extern _PTR malloc_region _PARAMS ((int, size_t));
+#ifdef __CYGWIN__
+#undef _malloc_region_r
+#define _malloc_region_r(r, i, s) malloc_region (i, s)
+#else
+extern _PTR _malloc_region_r _PARAMS ((struct _reent *, int, size_t));
+#endif
+
+/* Pools of fixed-size objects, see mpool.c.  Only nobjs, nused and
+   maxused are meant to be read by users.  */
+
+struct malloc_pool {
+  _PTR _free;      /* stack of free objects */
+  _PTR _blocks;    /* blocks obtained from malloc */
+  size_t _size;    /* size of one object */
+  size_t _grow;    /* objects per block, 0 for a caller buffer */
+  size_t nobjs;    /* objects owned by the pool */
+  size_t nused;    /* objects currently allocated */
+  size_t maxused;  /* largest value of nused so far */
+};
+
+/* Size of one object of a pool of SIZE byte objects.  A caller buffer
+   must hold N times this many bytes, suitably aligned.  */
+#define MALLOC_POOL_OBJSIZE(size) \
+  (((size) + sizeof (double) - 1) & ~(sizeof (double) - 1))
+
+/* Static initializer for a pool growing by N objects of SIZE bytes.  */
+#define MALLOC_POOL_INITIALIZER(size, n) \
+  { NULL, NULL, MALLOC_POOL_OBJSIZE (size), (n), 0, 0, 0 }
+
+extern _VOID malloc_pool_init _PARAMS ((struct malloc_pool *, size_t,
+					_PTR, size_t));
+
+extern _PTR malloc_pool_alloc _PARAMS ((struct malloc_pool *));
+extern _PTR _malloc_pool_alloc_r _PARAMS ((struct _reent *,
+					   struct malloc_pool *));
+
+extern _VOID malloc_pool_free _PARAMS ((struct malloc_pool *, _PTR));
+
+extern _VOID malloc_pool_destroy _PARAMS ((struct malloc_pool *));
+extern _VOID _malloc_pool_destroy_r _PARAMS ((struct _reent *,
+					      struct malloc_pool *));
+
 /* A compatibility routine for an earlier version of the allocator.  */
 
 extern _VOID mstats _PARAMS ((char *));
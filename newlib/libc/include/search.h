@@ -34,6 +34,11 @@ typedef struct node {
 	char         *key;
 	struct node  *llink, *rlink;
 } node_t;
+
+/* Nodes are allocated from a pool, see tsearch.c */
+node_t *__tnode_alloc _PARAMS ((void));
+void __tnode_free _PARAMS ((node_t *));
+void __tnode_trim _PARAMS ((void));
 #endif
 
 struct hsearch_data
@@ -574,6 +574,69 @@ FILE *_EXFUN(_fopencookie_r,(struct _reent *, void *__cookie,
 		const char *__mode, cookie_io_functions_t __functions));
 #endif /* ! __STRICT_ANSI__ */
 
+/*
+ * Printing with formats compiled once by pfmt_compile.
+ */
+
+#ifndef __STRICT_ANSI__
+/* One entry per conversion, with the literal text in front of it.  The
+   last entry has _code 0 and holds the text after the last conversion.  */
+typedef struct __pfmt
+{
+  _CONST char *_lit;		/* literal text, pointing into the format */
+  unsigned short _litlen;	/* length of the literal text */
+  unsigned short _flags;	/* flags and length modifiers */
+  short _width;			/* field width, or -1 for `*' */
+  short _prec;			/* precision, -1 if none, or -2 for `*' */
+  char _code;			/* conversion specifier */
+  char _sign;			/* ' ' or '+' flag */
+} pfmt_t;
+
+int	_EXFUN(pfmt_compile, (pfmt_t *, int, const char *));
+# ifndef _REENT_ONLY
+int	_EXFUN(fprintf_pfmt, (FILE *, const pfmt_t *, ...));
+int	_EXFUN(printf_pfmt, (const pfmt_t *, ...));
+int	_EXFUN(snprintf_pfmt, (char *, size_t, const pfmt_t *, ...));
+int	_EXFUN(vfprintf_pfmt, (FILE *, const pfmt_t *, __VALIST));
+int	_EXFUN(vsnprintf_pfmt, (char *, size_t, const pfmt_t *, __VALIST));
+# endif /* !_REENT_ONLY */
+int	_EXFUN(_vfprintf_pfmt_r, (struct _reent *, FILE *, const pfmt_t *,
+				  __VALIST));
+int	_EXFUN(_vsnprintf_pfmt_r, (struct _reent *, char *, size_t,
+				   const pfmt_t *, __VALIST));
+#endif /* ! __STRICT_ANSI__ */
+
+/*
+ * Binary logs: printf calls recorded without formatting, to be
+ * formatted later by blog_snprintf.
+ */
+
+#ifndef __STRICT_ANSI__
+#define BLOG_RECMAX	256	/* the biggest record blog_read returns */
+
+typedef struct __blog
+{
+  unsigned char *_buf;		/* ring buffer of records */
+  size_t _size;
+  size_t _head;			/* where the next record goes */
+  size_t _tail;			/* the oldest record */
+  unsigned long _dropped;	/* records that did not fit */
+} blog_t;
+
+void	_EXFUN(blog_init, (blog_t *, void *, size_t));
+int	_EXFUN(blog_printf, (blog_t *, const char *, ...)
+               _ATTRIBUTE ((__format__ (__printf__, 2, 3))));
+int	_EXFUN(vblog_printf, (blog_t *, const char *, __VALIST)
+               _ATTRIBUTE ((__format__ (__printf__, 2, 0))));
+int	_EXFUN(blog_read, (blog_t *, void *, size_t));
+# ifndef _REENT_ONLY
+int	_EXFUN(blog_snprintf, (char *, size_t, const char *, const void *,
+			       size_t));
+# endif /* !_REENT_ONLY */
+int	_EXFUN(_blog_snprintf_r, (struct _reent *, char *, size_t,
+				  const char *, const void *, size_t));
+#endif /* ! __STRICT_ANSI__ */
+
 #ifndef __CUSTOM_FILE_IO__
 /*
  * The __sfoo macros are here so that we can 
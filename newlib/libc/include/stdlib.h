@@ -117,6 +117,9 @@ int	_EXFUN(_mkstemps_r, (struct _reent *, char *, int));
 char *	_EXFUN(_mktemp_r, (struct _reent *, char *) _ATTRIBUTE ((__warning__ ("the use of `mktemp' is dangerous; use `mkstemp' instead"))));
 #endif
 _VOID	_EXFUN(qsort,(_PTR __base, size_t __nmemb, size_t __size, int(*_compar)(const _PTR, const _PTR)));
+#ifndef __STRICT_ANSI__
+_VOID	_EXFUN(qsort_r,(_PTR __base, size_t __nmemb, size_t __size, int(*_compar)(const _PTR, const _PTR, _PTR), _PTR __thunk));
+#endif
 int	_EXFUN(rand,(_VOID));
 _PTR	_EXFUN_NOTHROW(realloc,(_PTR __r, size_t __size));
 #ifndef __STRICT_ANSI__
@@ -204,6 +207,9 @@ int _EXFUN(posix_memalign,(void **, size_t, size_t));
 #endif /* ! __STRICT_ANSI__ */
 
 char *	_EXFUN(_dtoa_r,(struct _reent *, double, int, int, int *, int*, char**));
+#ifdef _NANO_MPREC_ARENA
+_VOID	_EXFUN(_mprec_arena_r,(struct _reent *, _PTR, size_t));
+#endif
 #ifndef __CYGWIN__
 _PTR	_EXFUN_NOTHROW(_malloc_r,(struct _reent *, size_t));
 _PTR	_EXFUN_NOTHROW(_calloc_r,(struct _reent *, size_t, size_t));
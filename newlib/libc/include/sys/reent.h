@@ -36,6 +36,31 @@ typedef __uint32_t __ULong;
 
 struct _reent;
 
+/* Per-thread cache of free chunks, private to nano malloc.  */
+struct __malloc_tcache;
+
+#ifdef _NANO_MALLOC_TCACHE
+#define _REENT_INIT_MALLOC_TCACHE(var) (var)->_malloc_tcache = _NULL;
+#else
+#define _REENT_INIT_MALLOC_TCACHE(var)
+#endif
+
+/* Memory the mprec routines take their big numbers from instead of
+   malloc, see _mprec_arena_r.  */
+#ifdef _NANO_MPREC_ARENA
+struct __mprec_arena
+{
+  char *_base;
+  char *_next;
+  char *_end;
+};
+#define _REENT_INIT_MPREC_ARENA(var) \
+  (var)->_mp_arena._base = (var)->_mp_arena._next = \
+    (var)->_mp_arena._end = _NULL;
+#else
+#define _REENT_INIT_MPREC_ARENA(var)
+#endif
+
 /*
  * If _REENT_SMALL is defined, we make struct _reent as small as possible,
  * by having nearly everything possible allocated at first use.
@@ -395,6 +420,12 @@ struct _reent
   __FILE *__sf;			        /* file descriptors */
   struct _misc_reent *_misc;            /* strtok, multibyte states */
   char *_signal_buf;                    /* strsignal */
+#ifdef _NANO_MALLOC_TCACHE
+  struct __malloc_tcache *_malloc_tcache;	/* nano malloc thread cache */
+#endif
+#ifdef _NANO_MPREC_ARENA
+  struct __mprec_arena _mp_arena;	/* memory for mprec */
+#endif
 };
 
 extern const struct __sFILE_fake __sf_fake_stdin;
@@ -453,6 +484,8 @@ extern const struct __sFILE_fake __sf_fake_stderr;
     (var)->__sf = 0; \
     (var)->_misc = _NULL; \
     (var)->_signal_buf = _NULL; \
+    _REENT_INIT_MALLOC_TCACHE(var) \
+    _REENT_INIT_MPREC_ARENA(var) \
   }
 
 /* Only built the assert() calls if we are built with debugging.  */
@@ -506,8 +539,17 @@ extern const struct __sFILE_fake __sf_fake_stderr;
   _r->_mp->_result = _r->_mp->_p5s = _NULL; \
   _r->_mp->_freelist = _NULL; \
 } while (0)
+#ifdef _NANO_MPREC_ARENA
+/* The mprec state comes from the arena as well.  */
+extern struct _mprec *_EXFUN(__mprec_state,(struct _reent *));
+#define _REENT_CHECK_MP(var) do { \
+  if ((var)->_mp == NULL) \
+    (var)->_mp = __mprec_state (var); \
+} while (0)
+#else
 #define _REENT_CHECK_MP(var) \
   _REENT_CHECK(var, _mp, struct _mprec *, sizeof *((var)->_mp), _REENT_INIT_MP(var))
+#endif
 
 #define _REENT_CHECK_EMERGENCY(var) \
   _REENT_CHECK(var, _emergency, char *, _REENT_EMERGENCY_SIZE, /* nothing */)
@@ -642,6 +684,12 @@ struct _reent
      would be broken otherwise).  */
   struct _glue __sglue;		/* root of glue chain */
   __FILE __sf[3];  		/* first three file descriptors */
+#ifdef _NANO_MALLOC_TCACHE
+  struct __malloc_tcache *_malloc_tcache;	/* nano malloc thread cache */
+#endif
+#ifdef _NANO_MPREC_ARENA
+  struct __mprec_arena _mp_arena;	/* memory for mprec */
+#endif
 };
 
 #define _REENT_INIT(var) \
@@ -747,6 +795,8 @@ struct _reent
     (var)->__sglue._niobs = 0; \
     (var)->__sglue._iobs = _NULL; \
     memset(&(var)->__sf, 0, sizeof((var)->__sf)); \
+    _REENT_INIT_MALLOC_TCACHE(var) \
+    _REENT_INIT_MPREC_ARENA(var) \
   }
 
 #define _REENT_CHECK_RAND48(ptr)	/* nothing */
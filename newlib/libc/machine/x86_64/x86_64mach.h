@@ -39,6 +39,12 @@
 #define r13 REG(r13)
 #define r14 REG(r14)
 #define r15 REG(r15)
+#define rip REG(rip)
+
+#define r8d  REG(r8d)
+#define r9d  REG(r9d)
+#define r10d REG(r10d)
+#define r11d REG(r11d)
 
 #define eax REG(eax)
 #define ebx REG(ebx)
@@ -73,6 +79,7 @@
 #define cl REG(cl)
 #define dl REG(dl)
 
+#define si  REG(si)
 #define sil REG(sil)
 
 #define mm1 REG(mm1)
@@ -91,6 +98,16 @@
 #define xmm5 REG(xmm5)
 #define xmm6 REG(xmm6)
 #define xmm7 REG(xmm7)
+#define xmm8 REG(xmm8)
+
+#define ymm0 REG(ymm0)
+#define ymm1 REG(ymm1)
+#define ymm2 REG(ymm2)
+#define ymm3 REG(ymm3)
+#define ymm4 REG(ymm4)
+#define ymm5 REG(ymm5)
+#define ymm6 REG(ymm6)
+#define ymm7 REG(ymm7)
 
 #define cr0 REG(cr0)
 #define cr1 REG(cr1)
@@ -104,6 +121,34 @@
 #define SOTYPE_FUNCTION(sym)
 #endif
 
+/* Bits of the value returned by __x86_64_features.  */
+
+#define X86_64_KNOWN 1                /* The other bits are valid */
+#define X86_64_AVX2  2                /* AVX2 usable, ymm state enabled */
+#define X86_64_ERMS  4                /* Enhanced rep movsb/stosb */
+
+/* Make SYM (name) jump to name_avx2 if the CPU has AVX2, and to
+   name_sse2 otherwise.  The first call asks __x86_64_features and
+   keeps the choice in name_impl, so that later calls cost one
+   indirect jump.  */
+
+#define SELECT_AVX2(name) \
+  jmp     *name##_impl (rip); \
+  .pushsection .data; \
+  .p2align 3; \
+name##_impl: \
+  .quad   name##_select; \
+  .popsection; \
+name##_select: \
+  call    SYM (__x86_64_features); \
+  leaq    name##_sse2 (rip), r11; \
+  testl   $X86_64_AVX2, eax; \
+  jz      1f; \
+  leaq    name##_avx2 (rip), r11; \
+1: \
+  movq    r11, name##_impl (rip); \
+  jmp     *r11
+
 #ifdef _I386MACH_ALLOW_HW_INTERRUPTS
 #define        __CLI
 #define        __STI
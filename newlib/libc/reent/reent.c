@@ -41,6 +41,21 @@ _DEFUN (cleanup_glue, (ptr, glue),
   _free_r (ptr, glue);
 }
 
+#ifdef _NANO_MALLOC_TCACHE
+extern void __malloc_tcache_release _PARAMS ((struct _reent *));
+#endif
+
+#ifdef _NANO_MPREC_ARENA
+/* Memory from the mprec arena does not belong to malloc.  */
+#define _mp_free_r(ptr, p) do { \
+  if ((char *) (p) < (ptr)->_mp_arena._base \
+      || (char *) (p) >= (ptr)->_mp_arena._end) \
+    _free_r (ptr, p); \
+} while (0)
+#else
+#define _mp_free_r _free_r
+#endif
+
 void
 _DEFUN (_reclaim_reent, (ptr),
      struct _reent *ptr)
@@ -64,14 +79,27 @@ _DEFUN (_reclaim_reent, (ptr),
 		{
 		  thisone = nextone;
 		  nextone = nextone->_next;
-		  _free_r (ptr, thisone);
+		  _mp_free_r (ptr, thisone);
 		}
 	    }    
 
-	  _free_r (ptr, _REENT_MP_FREELIST(ptr));
+	  _mp_free_r (ptr, _REENT_MP_FREELIST(ptr));
 	}
       if (_REENT_MP_RESULT(ptr))
-	_free_r (ptr, _REENT_MP_RESULT(ptr));
+	_mp_free_r (ptr, _REENT_MP_RESULT(ptr));
+      if (_REENT_MP_P5S(ptr))
+	{
+	  /* the powers of five cached by pow5mult */
+	  struct _Bigint *thisone, *nextone;
+
+	  nextone = _REENT_MP_P5S(ptr);
+	  while (nextone)
+	    {
+	      thisone = nextone;
+	      nextone = nextone->_next;
+	      _mp_free_r (ptr, thisone);
+	    }
+	}
 #ifdef _REENT_SMALL
       }
 #endif
@@ -80,7 +108,7 @@ _DEFUN (_reclaim_reent, (ptr),
       if (ptr->_emergency)
 	_free_r (ptr, ptr->_emergency);
       if (ptr->_mp)
-	_free_r (ptr, ptr->_mp);
+	_mp_free_r (ptr, ptr->_mp);
       if (ptr->_r48)
 	_free_r (ptr, ptr->_r48);
       if (ptr->_localtime_buf)
@@ -103,6 +131,11 @@ _DEFUN (_reclaim_reent, (ptr),
 	  if (ptr->__sglue._next)
 	    cleanup_glue (ptr, ptr->__sglue._next);
 	}
+#ifdef _NANO_MALLOC_TCACHE
+      /* Done last, since the _free_r calls above may fill the cache.  */
+      if (ptr->_malloc_tcache)
+	__malloc_tcache_release (ptr);
+#endif
 
       /* Malloc memory not reclaimed; no good way to return memory anyway. */
 
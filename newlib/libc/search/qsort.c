@@ -1,14 +1,19 @@
 /*
 FUNCTION
-<<qsort>>---sort an array
+<<qsort>>, <<qsort_r>>---sort an array
 
 INDEX
 	qsort
+INDEX
+	qsort_r
 
 ANSI_SYNOPSIS
 	#include <stdlib.h>
 	void qsort(void *<[base]>, size_t <[nmemb]>, size_t <[size]>,
 		   int (*<[compar]>)(const void *, const void *) );
+	void qsort_r(void *<[base]>, size_t <[nmemb]>, size_t <[size]>,
+		   int (*<[compar]>)(const void *, const void *, void *),
+		   void *<[arg]>);
 
 TRAD_SYNOPSIS
 	#include <stdlib.h>
@@ -34,11 +39,20 @@ the first argument is greater than the second (where ``less than'' and
 The array is sorted in place; that is, when <<qsort>> returns, the
 array elements beginning at <[base]> have been reordered.
 
+<<qsort_r>> is like <<qsort>>, but passes <[arg]> as a third argument
+to each call of <[compar]>, so that the comparison can depend on data
+of the caller without a global variable.
+
+The sort takes time proportional to <[nmemb]> log <[nmemb]> in the
+worst case, and stack space proportional to log <[nmemb]>.  It is not
+stable.
+
 RETURNS
-<<qsort>> does not return a result.
+<<qsort>> and <<qsort_r>> do not return a result.
 
 PORTABILITY
 <<qsort>> is required by ANSI (without specifying the sorting algorithm).
+<<qsort_r>> is in POSIX.1-2024.
 */
 
 /*-
@@ -76,18 +90,35 @@ PORTABILITY
 
 #include <_ansi.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #ifndef __GNUC__
 #define inline
 #endif
 
-static inline char	*med3 _PARAMS((char *, char *, char *, int (*)()));
-static inline void	 swapfunc _PARAMS((char *, char *, int, int));
+#ifdef I_AM_QSORT_R
+typedef int		 cmp_t _PARAMS((const void *, const void *, void *));
+#define	CMP(t, x, y)	(cmp((x), (y), (t)))
+#else
+typedef int		 cmp_t _PARAMS((const void *, const void *));
+#define	CMP(t, x, y)	(cmp((x), (y)))
+#endif
+
+static inline char	*med3 _PARAMS((char *, char *, char *, cmp_t *, void *));
+static inline void	 swapfunc _PARAMS((char *, char *, size_t, int));
 
 #define min(a, b)	(a) < (b) ? a : b
 
 /*
- * Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Arrays shorter than this are sorted by insertion.
+ */
+#define	INSERTION_MAX	10
+
+/*
+ * Qsort routine from Bentley & McIlroy's "Engineering a Sort Function",
+ * with the depth limit of Musser's introsort: a range that needs more
+ * than 2 log2 n levels of partitioning is heapsorted, so that bad
+ * pivots cannot make the sort quadratic.
  */
 #define swapcode(TYPE, parmi, parmj, n) { 		\
 	long i = (n) / sizeof (TYPE); 			\
@@ -100,81 +131,182 @@ static inline void	 swapfunc _PARAMS((char *, char *, int, int));
         } while (--i > 0);				\
 }
 
-#define SWAPINIT(a, es) swaptype = ((char *)a - (char *)0) % sizeof(long) || \
-	es % sizeof(long) ? 2 : es == sizeof(long)? 0 : 1;
+/*
+ * How elements are swapped: one or two moves for the common sizes,
+ * else a loop over words or bytes.
+ */
+#define	SWAP_BYTES	0
+#define	SWAP_WORDS	1
+#define	SWAP_4		2
+#define	SWAP_8		3
+#define	SWAP_16		4
+
+#define	ALIGNED(a, n)	((uintptr_t)(a) % (n) == 0)
+
+#define SWAPINIT(a, es) swaptype =					\
+	es == 4 && ALIGNED(a, 4) ? SWAP_4 :				\
+	es == 8 && ALIGNED(a, 8) ? SWAP_8 :				\
+	es == 16 && ALIGNED(a, 8) ? SWAP_16 :				\
+	ALIGNED(a, sizeof(long)) && es % sizeof(long) == 0 ?		\
+	SWAP_WORDS : SWAP_BYTES;
 
 static inline void
 _DEFUN(swapfunc, (a, b, n, swaptype),
 	char *a _AND
 	char *b _AND
-	int n _AND
+	size_t n _AND
 	int swaptype)
 {
-	if(swaptype <= 1) 
-		swapcode(long, a, b, n)
-	else
+	if (swaptype == SWAP_BYTES)
 		swapcode(char, a, b, n)
+	else if (swaptype == SWAP_4)
+		swapcode(uint32_t, a, b, n)
+	else
+		swapcode(long, a, b, n)
 }
 
+#if defined(PREFER_SIZE_OVER_SPEED) || defined(__OPTIMIZE_SIZE__)
+#define swap(a, b)	swapfunc(a, b, es, swaptype)
+#else
 #define swap(a, b)					\
-	if (swaptype == 0) {				\
-		long t = *(long *)(a);			\
-		*(long *)(a) = *(long *)(b);		\
-		*(long *)(b) = t;			\
+	if (swaptype == SWAP_4) {			\
+		uint32_t t = *(uint32_t *)(a);		\
+		*(uint32_t *)(a) = *(uint32_t *)(b);	\
+		*(uint32_t *)(b) = t;			\
+	} else if (swaptype == SWAP_8) {		\
+		uint64_t t = *(uint64_t *)(a);		\
+		*(uint64_t *)(a) = *(uint64_t *)(b);	\
+		*(uint64_t *)(b) = t;			\
+	} else if (swaptype == SWAP_16) {		\
+		uint64_t t = *(uint64_t *)(a);		\
+		uint64_t u = ((uint64_t *)(a))[1];	\
+		*(uint64_t *)(a) = *(uint64_t *)(b);	\
+		((uint64_t *)(a))[1] = ((uint64_t *)(b))[1]; \
+		*(uint64_t *)(b) = t;			\
+		((uint64_t *)(b))[1] = u;		\
 	} else						\
 		swapfunc(a, b, es, swaptype)
+#endif
 
 #define vecswap(a, b, n) 	if ((n) > 0) swapfunc(a, b, n, swaptype)
 
 static inline char *
-_DEFUN(med3, (a, b, c, cmp),
+_DEFUN(med3, (a, b, c, cmp, thunk),
 	char *a _AND
 	char *b _AND
 	char *c _AND
-	int (*cmp)())
+	cmp_t *cmp _AND
+	void *thunk)
 {
-	return cmp(a, b) < 0 ?
-	       (cmp(b, c) < 0 ? b : (cmp(a, c) < 0 ? c : a ))
-              :(cmp(b, c) > 0 ? b : (cmp(a, c) < 0 ? a : c ));
+	return CMP(thunk, a, b) < 0 ?
+	       (CMP(thunk, b, c) < 0 ? b : (CMP(thunk, a, c) < 0 ? c : a ))
+              :(CMP(thunk, b, c) > 0 ? b : (CMP(thunk, a, c) < 0 ? a : c ));
 }
 
-void
-_DEFUN(qsort, (a, n, es, cmp),
-	void *a _AND
+/*
+ * Insertion sort, giving up after LIMIT swaps.  Returns 1 if the array
+ * is sorted.
+ */
+static int
+_DEFUN(inssort, (a, n, es, swaptype, limit, cmp, thunk),
+	char *a _AND
+	size_t n _AND
+	size_t es _AND
+	int swaptype _AND
+	size_t limit _AND
+	cmp_t *cmp _AND
+	void *thunk)
+{
+	char *pl, *pm;
+
+	for (pm = a + es; pm < a + n * es; pm += es)
+		for (pl = pm; pl > a && CMP(thunk, pl - es, pl) > 0;
+		     pl -= es) {
+			if (limit-- == 0)
+				return 0;
+			swap(pl, pl - es);
+		}
+	return 1;
+}
+
+static void
+_DEFUN(heapsort, (a, n, es, swaptype, cmp, thunk),
+	char *a _AND
+	size_t n _AND
+	size_t es _AND
+	int swaptype _AND
+	cmp_t *cmp _AND
+	void *thunk)
+{
+	char *pl, *pm;
+	size_t i, j, k, m;
+
+	/*
+	 * Make the array a heap with its largest element at A, then move
+	 * the top to the end of the heap until the heap is empty.
+	 */
+	for (m = n, i = n / 2; m > 1; ) {
+		if (i > 0)
+			i--;
+		else {
+			m--;
+			swap(a, a + m * es);
+		}
+		/* Sift element I down the heap of M elements.  */
+		for (j = i; j < m / 2; j = k) {
+			k = 2 * j + 1;
+			pm = a + k * es;
+			if (k + 1 < m && CMP(thunk, pm, pm + es) < 0) {
+				k++;
+				pm += es;
+			}
+			pl = a + j * es;
+			if (CMP(thunk, pl, pm) >= 0)
+				break;
+			swap(pl, pm);
+		}
+	}
+}
+
+static void
+_DEFUN(introsort, (a, n, es, swaptype, depth, cmp, thunk),
+	char *a _AND
 	size_t n _AND
 	size_t es _AND
-	int (*cmp)())
+	int swaptype _AND
+	int depth _AND
+	cmp_t *cmp _AND
+	void *thunk)
 {
 	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
-	int d, r, swaptype, swap_cnt;
+	size_t d, nl, nr;
+	int r, swap_cnt;
 
-loop:	SWAPINIT(a, es);
-	swap_cnt = 0;
-	if (n < 7) {
-		for (pm = (char *) a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && cmp(pl - es, pl) > 0;
-			     pl -= es)
-				swap(pl, pl - es);
+loop:	if (n < INSERTION_MAX) {
+		inssort(a, n, es, swaptype, (size_t) -1, cmp, thunk);
 		return;
 	}
-	pm = (char *) a + (n / 2) * es;
-	if (n > 7) {
-		pl = a;
-		pn = (char *) a + (n - 1) * es;
-		if (n > 40) {
-			d = (n / 8) * es;
-			pl = med3(pl, pl + d, pl + 2 * d, cmp);
-			pm = med3(pm - d, pm, pm + d, cmp);
-			pn = med3(pn - 2 * d, pn - d, pn, cmp);
-		}
-		pm = med3(pl, pm, pn, cmp);
+	if (depth-- == 0) {
+		heapsort(a, n, es, swaptype, cmp, thunk);
+		return;
+	}
+	swap_cnt = 0;
+	pm = a + (n / 2) * es;
+	pl = a;
+	pn = a + (n - 1) * es;
+	if (n > 40) {
+		d = (n / 8) * es;
+		pl = med3(pl, pl + d, pl + 2 * d, cmp, thunk);
+		pm = med3(pm - d, pm, pm + d, cmp, thunk);
+		pn = med3(pn - 2 * d, pn - d, pn, cmp, thunk);
 	}
+	pm = med3(pl, pm, pn, cmp, thunk);
 	swap(a, pm);
-	pa = pb = (char *) a + es;
+	pa = pb = a + es;
 
-	pc = pd = (char *) a + (n - 1) * es;
+	pc = pd = a + (n - 1) * es;
 	for (;;) {
-		while (pb <= pc && (r = cmp(pb, a)) <= 0) {
+		while (pb <= pc && (r = CMP(thunk, pb, a)) <= 0) {
 			if (r == 0) {
 				swap_cnt = 1;
 				swap(pa, pb);
@@ -182,7 +314,7 @@ loop:	SWAPINIT(a, es);
 			}
 			pb += es;
 		}
-		while (pb <= pc && (r = cmp(pc, a)) >= 0) {
+		while (pb <= pc && (r = CMP(thunk, pc, a)) >= 0) {
 			if (r == 0) {
 				swap_cnt = 1;
 				swap(pc, pd);
@@ -197,26 +329,73 @@ loop:	SWAPINIT(a, es);
 		pb += es;
 		pc -= es;
 	}
-	if (swap_cnt == 0) {  /* Switch to insertion sort */
-		for (pm = (char *) a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && cmp(pl - es, pl) > 0; 
-			     pl -= es)
-				swap(pl, pl - es);
-		return;
+
+	pn = a + n * es;
+	d = min(pa - a, pb - pa);
+	vecswap(a, pb - d, d);
+	d = min(pd - pc, pn - pd - es);
+	vecswap(pb, pn - d, d);
+	nl = (pb - pa) / es;
+	nr = (pd - pc) / es;
+
+	/*
+	 * Nothing was out of place around the pivot, so the parts may
+	 * well be sorted already.  Try an insertion sort on each, but give
+	 * up after as many swaps as the part has elements: that costs no
+	 * more than another partition, so an unlucky input cannot make
+	 * the sort quadratic as a full insertion sort would.
+	 */
+	if (swap_cnt == 0) {
+		if (inssort(a, nl, es, swaptype, nl, cmp, thunk))
+			nl = 0;
+		if (inssort(pn - nr * es, nr, es, swaptype, nr, cmp, thunk))
+			nr = 0;
 	}
 
-	pn = (char *) a + n * es;
-	r = min(pa - (char *)a, pb - pa);
-	vecswap(a, pb - r, r);
-	r = min(pd - pc, pn - pd - es);
-	vecswap(pb, pn - r, r);
-	if ((r = pb - pa) > es)
-		qsort(a, r / es, es, cmp);
-	if ((r = pd - pc) > es) { 
-		/* Iterate rather than recurse to save stack space */
-		a = pn - r;
-		n = r / es;
-		goto loop;
+	/*
+	 * Recurse into the smaller part and iterate on the larger one, so
+	 * that the stack holds at most log2 n frames.
+	 */
+	if (nl < nr) {
+		if (nl > 1)
+			introsort(a, nl, es, swaptype, depth, cmp, thunk);
+		a = pn - nr * es;
+		n = nr;
+	} else {
+		if (nr > 1)
+			introsort(pn - nr * es, nr, es, swaptype, depth,
+				  cmp, thunk);
+		n = nl;
 	}
-/*		qsort(pn - r, r / es, es, cmp);*/
+	if (n > 1)
+		goto loop;
+}
+
+#ifdef I_AM_QSORT_R
+void
+_DEFUN(qsort_r, (a, n, es, cmp, thunk),
+	void *a _AND
+	size_t n _AND
+	size_t es _AND
+	cmp_t *cmp _AND
+	void *thunk)
+#else
+void
+_DEFUN(qsort, (a, n, es, cmp),
+	void *a _AND
+	size_t n _AND
+	size_t es _AND
+	cmp_t *cmp)
+#endif
+{
+	size_t m;
+	int depth, swaptype;
+#ifndef I_AM_QSORT_R
+	void *thunk = NULL;
+#endif
+
+	SWAPINIT(a, es);
+	for (depth = 0, m = n; m > 1; m >>= 1)
+		depth += 2;
+	introsort(a, n, es, swaptype, depth, cmp, thunk);
 }
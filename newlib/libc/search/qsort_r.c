@@ -0,0 +1,4 @@
+/* qsort_r: qsort passing an argument to the comparison function.  */
+
+#define I_AM_QSORT_R
+#include "qsort.c"
@@ -61,7 +61,7 @@ _DEFUN(tdelete, (vkey, vrootp, compar),
 			q->rlink = (*rootp)->rlink;
 		}
 	}
-	free(*rootp);				/* D4: Free node */
+	__tnode_free(*rootp);			/* D4: Free node */
 	*rootp = q;				/* link parent to new node */
 	return p;
 }
@@ -36,7 +36,7 @@ trecurse(root, free_action)
     trecurse(root->rlink, free_action);
 
   (*free_action) ((void *) root->key);
-  free(root);
+  __tnode_free(root);
 }
 
 void
@@ -48,4 +48,5 @@ _DEFUN(tdestroy, (vrootp, freefct),
 
   if (root != NULL)
     trecurse(root, freefct);
+  __tnode_trim();
 }
@@ -22,6 +22,50 @@ __RCSID("$NetBSD: tsearch.c,v 1.3 1999/09/16 11:45:37 lukem Exp $");
 #define _SEARCH_PRIVATE
 #include <search.h>
 #include <stdlib.h>
+#include <malloc.h>
+#include <reent.h>
+#include <sys/lock.h>
+
+/* Nodes of all trees are allocated from one pool, which grows by
+   TNODE_GROW nodes at a time.  The pool is kept when the trees become
+   empty, as a tree that goes between zero and one node would otherwise
+   get and release a whole block each time.  tdestroy gives it back to
+   malloc if no node is left.  */
+#define TNODE_GROW 16
+
+static struct malloc_pool tnode_pool =
+  MALLOC_POOL_INITIALIZER (sizeof (node_t), TNODE_GROW);
+
+__LOCK_INIT(static, tnode_lock);
+
+node_t *
+_DEFUN_VOID(__tnode_alloc)
+{
+	node_t *q;
+
+	__lock_acquire(tnode_lock);
+	q = _malloc_pool_alloc_r(_REENT, &tnode_pool);
+	__lock_release(tnode_lock);
+	return q;
+}
+
+void
+_DEFUN(__tnode_free, (q),
+	node_t *q)
+{
+	__lock_acquire(tnode_lock);
+	malloc_pool_free(&tnode_pool, q);
+	__lock_release(tnode_lock);
+}
+
+void
+_DEFUN_VOID(__tnode_trim)
+{
+	__lock_acquire(tnode_lock);
+	if (tnode_pool.nused == 0)
+		_malloc_pool_destroy_r(_REENT, &tnode_pool);
+	__lock_release(tnode_lock);
+}
 
 /* find or insert datum into search tree */
 void *
@@ -47,7 +91,7 @@ _DEFUN(tsearch, (vkey, vrootp, compar),
 		    &(*rootp)->rlink;		/* T4: follow right branch */
 	}
 
-	q = malloc(sizeof(node_t));		/* T5: key not found */
+	q = __tnode_alloc();			/* T5: key not found */
 	if (q != 0) {				/* make new node */
 		*rootp = q;			/* link new node to old */
 		/* LINTED const castaway ok */
@@ -0,0 +1,259 @@
+/*
+FUNCTION
+<<blog_printf>>, <<blog_read>>, <<blog_snprintf>>---record printf calls and format them later
+
+INDEX
+	blog_init
+INDEX
+	blog_printf
+INDEX
+	vblog_printf
+INDEX
+	blog_read
+INDEX
+	blog_snprintf
+INDEX
+	_blog_snprintf_r
+
+ANSI_SYNOPSIS
+	#include <stdio.h>
+	void blog_init(blog_t *<[log]>, void *<[buf]>, size_t <[size]>);
+	int blog_printf(blog_t *<[log]>, const char *<[format]>, ...);
+	int vblog_printf(blog_t *<[log]>, const char *<[format]>,
+			va_list <[list]>);
+	int blog_read(blog_t *<[log]>, void *<[rec]>, size_t <[size]>);
+	int blog_snprintf(char *<[str]>, size_t <[size]>,
+			const char *<[format]>, const void *<[rec]>,
+			size_t <[len]>);
+
+	int _blog_snprintf_r(struct _reent *<[reent]>, char *<[str]>,
+			size_t <[size]>, const char *<[format]>,
+			const void *<[rec]>, size_t <[len]>);
+
+TRAD_SYNOPSIS
+	#include <stdio.h>
+	int blog_read(<[log]>, <[rec]>, <[size]>)
+	blog_t *<[log]>;
+	void *<[rec]>;
+	size_t <[size]>;
+
+DESCRIPTION
+A binary log keeps what a <<printf>> call would print without doing
+the formatting, which is left to a later time or another machine.
+
+<<blog_init>> makes the <[size]> bytes at <[buf]> the ring buffer of
+the log <[log]>.
+
+<<blog_printf>> and <<vblog_printf>> take the same arguments as
+<<printf>> and <<vprintf>>.  They walk <[format]> as <<printf>> does
+and append to the log a record holding the pointer <[format]> and the
+raw arguments.  Strings are copied into the record, up to the precision
+of their conversion; <<%n>> conversions are ignored.  When there is no
+room for the record it is dropped and <[log]>-><<_dropped>> counted up.
+A record is never bigger than <<BLOG_RECMAX>> bytes; a longer string is
+cut short to fit.
+
+<<blog_read>> moves the oldest record of <[log]> into the <[size]>
+bytes at <[rec]>.  <<blog_printf>> only changes the head of the ring
+and <<blog_read>> only its tail, but neither takes a lock.
+
+<<blog_snprintf>> formats the record of <[len]> bytes at <[rec]> into
+<[str]> like <<snprintf>> with the original arguments, using the same
+conversion functions.  If <[format]> is NULL the format pointer of the
+record is used, which is right in the program that wrote the record.
+Elsewhere, for instance in a tool on a host machine, <[format]> must be
+the same format, looked up from the pointer stored after the record
+length; the host must then have the same sizes, alignment and byte
+order for the argument types as the target.
+
+<<_blog_snprintf_r>> is the reentrant version of <<blog_snprintf>>,
+taking the reentrancy structure <[reent]>.
+
+RETURNS
+<<blog_printf>> and <<vblog_printf>> return the size of the record, or
+<<EOF>> if it was dropped.
+
+<<blog_read>> returns the size of the record, 0 if the log is empty,
+or <<EOF>> if the record is bigger than <[size]>; the record then stays
+in the log.
+
+<<blog_snprintf>> returns what <<snprintf>> would, or <<EOF>> with
+<<errno>> set to <<EINVAL>> if the record does not match the format.
+
+PORTABILITY
+These functions are specific to newlib-nano.
+
+Supporting OS subroutines required: <<sbrk>>.
+*/
+
+#include <_ansi.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include "local.h"
+#include "vfprintf_local.h"
+#include "blog.h"
+
+_VOID
+_DEFUN(blog_init, (log, buf, size),
+       blog_t *log _AND
+       _PTR buf    _AND
+       size_t size)
+{
+	log->_buf = buf;
+	log->_size = size;
+	log->_head = 0;
+	log->_tail = 0;
+	log->_dropped = 0;
+}
+
+/* Store an argument of TYPE in the record, or drop the record if it
+   does not fit.  */
+#define PUT(type) {					\
+	off = BLOG_ALIGN (off, type);			\
+	if (off + sizeof (type) > BLOG_RECMAX)		\
+		goto drop;				\
+	*(type *) (rec.c + off) = GET_ARG (N, ap, type);\
+	off += sizeof (type);				\
+}
+
+int
+_DEFUN(vblog_printf, (log, fmt, ap),
+       blog_t *log      _AND
+       _CONST char *fmt _AND
+       va_list ap)
+{
+	union {
+		unsigned char c[BLOG_RECMAX];
+		_CONST char *p;
+		long long ll;
+		double d;
+	} rec;
+	size_t off = BLOG_HDR, head, tail, len;
+	_CONST char *s;
+	pfmt_t pf;
+	int prec;
+
+	rec.p = fmt;
+	for (;;) {
+		if ((fmt = __pfmt_parse (&pf, fmt)) == NULL)
+			goto drop;
+		if (pf._code == '\0')
+			break;
+		if (pf._width == -1)
+			PUT (int);
+		prec = pf._prec;
+		if (prec == -2) {
+			PUT (int);
+			prec = *(int *) (rec.c + off - sizeof (int));
+		}
+		switch (_blog_argtype (&pf)) {
+		case BLOG_INT:
+			PUT (int);
+			break;
+		case BLOG_LONG:
+			PUT (long);
+			break;
+		case BLOG_LLONG:
+			PUT (long long);
+			break;
+		case BLOG_DOUBLE:
+			PUT (double);
+			break;
+		case BLOG_LDOUBLE:
+			PUT (_LONG_DOUBLE);
+			break;
+		case BLOG_PTR:
+			PUT (_PTR);
+			break;
+		case BLOG_COUNT:
+			GET_ARG (N, ap, _PTR);
+			break;
+		case BLOG_STR:
+			if ((s = GET_ARG (N, ap, char_ptr_t)) == NULL)
+				s = "(null)";
+			/* Leave room for the NUL.  */
+			if (off == BLOG_RECMAX)
+				goto drop;
+			for (; *s != '\0' && prec != 0 && off < BLOG_RECMAX - 1;
+			     prec--)
+				rec.c[off++] = *s++;
+			rec.c[off++] = '\0';
+			break;
+		}
+	}
+
+	/* Append the record where it fits in one piece, keeping the head
+	   off the tail unless the ring is empty.  */
+	len = off;
+	*(unsigned short *) (rec.c + BLOG_LEN) = len;
+	head = log->_head;
+	tail = log->_tail;
+	if (head >= tail && log->_size - head >= len + (tail == 0)) {
+		memcpy (log->_buf + head, rec.c, len);
+		head += len;
+		if (head == log->_size)
+			head = 0;
+	}
+	else if (head >= tail && len < tail) {
+		/* Mark the rest of the ring as unused and start over.  */
+		if (log->_size - head >= BLOG_HDR)
+			memset (log->_buf + head + BLOG_LEN, 0,
+				sizeof (unsigned short));
+		memcpy (log->_buf, rec.c, len);
+		head = len;
+	}
+	else if (head < tail && tail - head > len) {
+		memcpy (log->_buf + head, rec.c, len);
+		head += len;
+	}
+	else
+		goto drop;
+	log->_head = head;
+	return len;
+
+drop:
+	log->_dropped++;
+	return EOF;
+}
+
+int
+_DEFUN(blog_printf, (log, fmt),
+       blog_t *log      _AND
+       _CONST char *fmt _DOTS)
+{
+	int ret;
+	va_list ap;
+
+	va_start (ap, fmt);
+	ret = vblog_printf (log, fmt, ap);
+	va_end (ap);
+	return ret;
+}
+
+int
+_DEFUN(blog_read, (log, rec, size),
+       blog_t *log _AND
+       _PTR rec    _AND
+       size_t size)
+{
+	size_t tail = log->_tail;
+	unsigned short len;
+
+	if (tail == log->_head)
+		return 0;
+	if (log->_size - tail < BLOG_HDR
+	    || (memcpy (&len, log->_buf + tail + BLOG_LEN, sizeof len),
+		len == 0)) {
+		tail = 0;
+		memcpy (&len, log->_buf + BLOG_LEN, sizeof len);
+	}
+	if (len > size)
+		return EOF;
+	memcpy (rec, log->_buf + tail, len);
+	tail += len;
+	if (tail == log->_size)
+		tail = 0;
+	log->_tail = tail;
+	return len;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012 ARM Ltd
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the company may not be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* The records of a binary log, written by vblog_printf and read back by
+   _blog_snprintf_r.  A record starts with the format pointer and the
+   record length as an unsigned short, followed by the arguments the
+   format takes, each in its own type.  A string is stored in the record,
+   with its NUL, instead of its pointer.  Other arguments are aligned to
+   their size, up to that of a double, from the start of the record, so
+   that vblog_printf can store them without memcpy.
+
+   In the ring a record length of 0, or too few bytes left before the
+   end for a header, means the next record starts at the beginning.  */
+
+#ifndef _BLOG_H_
+#define _BLOG_H_
+
+#define BLOG_LEN	sizeof (_CONST char *)	/* offset of the length */
+#define BLOG_HDR	(BLOG_LEN + sizeof (unsigned short))
+
+/* Round the offset OFF up for an argument of TYPE.  */
+#define BLOG_ALIGN(off, type) \
+	(sizeof (type) < sizeof (double) \
+	 ? ((off) + sizeof (type) - 1) & ~(sizeof (type) - 1) \
+	 : ((off) + sizeof (double) - 1) & ~(sizeof (double) - 1))
+
+#define BLOG_NONE	0		/* no argument */
+#define BLOG_INT	1		/* int, or a promoted char or short */
+#define BLOG_LONG	2		/* long, size_t, ptrdiff_t */
+#define BLOG_LLONG	3		/* long long, intmax_t */
+#define BLOG_DOUBLE	4
+#define BLOG_LDOUBLE	5
+#define BLOG_STR	6		/* char *, stored as the string */
+#define BLOG_PTR	7		/* void * */
+#define BLOG_COUNT	8		/* %n: consumed, never stored */
+
+/* Return the type of the argument the conversion of PF takes, the way
+   _printf_i, _printf_c99 and _printf_float fetch it.  */
+static __inline__ int
+_blog_argtype (_CONST pfmt_t *pf)
+{
+	switch (pf->_code) {
+	case 'd':
+	case 'i':
+	case 'o':
+	case 'u':
+	case 'x':
+	case 'X':
+		if (pf->_flags & (LLINT | MAXINT))
+			return BLOG_LLONG;
+		if (pf->_flags & (LONGINT | SIZEINT | PTRINT))
+			return BLOG_LONG;
+		return BLOG_INT;
+	case 'c':
+		return BLOG_INT;
+	case 'e':
+	case 'f':
+	case 'g':
+	case 'E':
+	case 'F':
+	case 'G':
+		return (pf->_flags & LONGDBL) ? BLOG_LDOUBLE : BLOG_DOUBLE;
+	case 's':
+		return BLOG_STR;
+	case 'p':
+		return BLOG_PTR;
+	case 'n':
+		return BLOG_COUNT;
+	default:
+		return BLOG_NONE;
+	}
+}
+
+#endif /* _BLOG_H_ */
@@ -0,0 +1,189 @@
+/* doc in blog.c */
+
+#include <newlib.h>
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <errno.h>
+#include "local.h"
+#include "vfprintf_local.h"
+#include "blog.h"
+
+/* Hand one argument from a record to _printf_conv, in a va_list of its
+   own.  */
+static int
+_blog_conv (struct _reent *data,
+	    struct _prt_data_t *pdata,
+	    FILE *fp, ...)
+{
+	va_list ap;
+	int n;
+
+	va_start (ap, fp);
+	n = _printf_conv (data, pdata, fp, __ssputs_r, &ap);
+	va_end (ap);
+	return n;
+}
+
+/* Take an argument of TYPE from the record into V.  */
+#define GET(v, type) {				\
+	off = BLOG_ALIGN (off, type);		\
+	if (off + sizeof (type) > len)		\
+		goto bad;			\
+	memcpy (&(v), r + off, sizeof (type));	\
+	off += sizeof (type);			\
+}
+
+int
+_DEFUN(_blog_snprintf_r, (ptr, str, size, fmt, rec, len),
+       struct _reent *ptr _AND
+       char *str          _AND
+       size_t size        _AND
+       _CONST char *fmt   _AND
+       _CONST _PTR rec    _AND
+       size_t len)
+{
+	_CONST unsigned char *r = rec, *nul;
+	size_t off = BLOG_HDR;
+	struct _prt_data_t prt_data;
+	unsigned short reclen;
+	_CONST char *recfmt;
+	pfmt_t pf;
+	FILE f;
+	int n;
+	union {
+		int i;
+		long l;
+		long long ll;
+		double d;
+		_LONG_DOUBLE ld;
+		_PTR v;
+	} arg;
+
+	if (size > INT_MAX) {
+		ptr->_errno = EOVERFLOW;
+		return EOF;
+	}
+	f._flags = __SWR | __SSTR;
+	f._bf._base = f._p = (unsigned char *) str;
+	f._bf._size = f._w = (size > 0 ? size - 1 : 0);
+	f._file = -1;  /* No file. */
+	if (len < BLOG_HDR)
+		goto bad;
+	memcpy (&recfmt, r, sizeof recfmt);
+	memcpy (&reclen, r + BLOG_LEN, sizeof reclen);
+	if (reclen != len)
+		goto bad;
+	if (fmt == NULL)
+		fmt = recfmt;
+	prt_data.ret = 0;
+	prt_data.blank = ' ';
+	prt_data.zero = '0';
+
+	/* Walk the format as vblog_printf did, taking the arguments from
+	   the record instead of a va_list.  */
+	for (;;) {
+		if ((fmt = __pfmt_parse (&pf, fmt)) == NULL)
+			goto bad;
+		if (pf._litlen != 0) {
+			__ssputs_r (ptr, &f, pf._lit, pf._litlen);
+			prt_data.ret += pf._litlen;
+		}
+		if (pf._code == '\0')
+			break;
+
+		prt_data.flags = pf._flags;
+		prt_data.width = pf._width;
+		prt_data.prec = pf._prec;
+		prt_data.dprec = 0;
+		prt_data.l_buf[0] = pf._sign;
+#ifdef FLOATING_POINT
+		prt_data.lead = 0;
+#endif
+		if (prt_data.width < 0) {
+			GET (prt_data.width, int);
+			if (prt_data.width < 0) {
+				prt_data.width = -prt_data.width;
+				prt_data.flags |= LADJUST;
+			}
+		}
+		if (prt_data.prec == -2) {
+			GET (prt_data.prec, int);
+			if (prt_data.prec < 0)
+				prt_data.prec = -1;
+		}
+		prt_data.code = pf._code;
+		switch (_blog_argtype (&pf)) {
+		case BLOG_INT:
+			GET (arg.i, int);
+			n = _blog_conv (ptr, &prt_data, &f, arg.i);
+			break;
+		case BLOG_LONG:
+			GET (arg.l, long);
+			n = _blog_conv (ptr, &prt_data, &f, arg.l);
+			break;
+		case BLOG_LLONG:
+			GET (arg.ll, long long);
+			n = _blog_conv (ptr, &prt_data, &f, arg.ll);
+			break;
+		case BLOG_DOUBLE:
+			GET (arg.d, double);
+			n = _blog_conv (ptr, &prt_data, &f, arg.d);
+			break;
+		case BLOG_LDOUBLE:
+			GET (arg.ld, _LONG_DOUBLE);
+			n = _blog_conv (ptr, &prt_data, &f, arg.ld);
+			break;
+		case BLOG_PTR:
+			GET (arg.v, _PTR);
+			n = _blog_conv (ptr, &prt_data, &f, arg.v);
+			break;
+		case BLOG_STR:
+			if ((nul = memchr (r + off, '\0', len - off)) == NULL)
+				goto bad;
+			n = _blog_conv (ptr, &prt_data, &f,
+					(_CONST char *) r + off);
+			off = nul + 1 - r;
+			break;
+		case BLOG_COUNT:
+			n = 0;
+			break;
+		default:
+			n = _blog_conv (ptr, &prt_data, &f, 0);
+			break;
+		}
+		if (n == -1)
+			goto error;
+		prt_data.ret += n;
+	}
+	if (off != len)
+		goto bad;
+	if (size > 0)
+		*f._p = 0;
+	return prt_data.ret;
+
+bad:
+	ptr->_errno = EINVAL;
+error:
+	if (size > 0)
+		*f._p = 0;
+	return EOF;
+}
+
+#ifndef _REENT_ONLY
+
+int
+_DEFUN(blog_snprintf, (str, size, fmt, rec, len),
+       char *str        _AND
+       size_t size      _AND
+       _CONST char *fmt _AND
+       _CONST _PTR rec  _AND
+       size_t len)
+{
+	return _blog_snprintf_r (_REENT, str, size, fmt, rec, len);
+}
+
+#endif /* !_REENT_ONLY */
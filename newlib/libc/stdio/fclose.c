@@ -98,7 +98,7 @@ _DEFUN(_fclose_r, (rptr, fp),
     FREEUB (rptr, fp);
   if (HASLB (fp))
     FREELB (rptr, fp);
-  fp->_flags = 0;		/* release this FILE for reuse */
+  __sfp_free (fp);		/* release this FILE for reuse */
   _funlockfile (fp);
 #ifndef __SINGLE_THREAD__
   __lock_close_recursive (fp->_lock);
@@ -96,6 +96,101 @@ _DEFUN(__sfmoreglue, (d, n),
   return g;
 }
 
+/*
+ * The streams of the global reent that have been set up for line
+ * buffered output, for __srefill_r to flush without walking every FILE.
+ * A stream is listed when __swsetup_r or setvbuf makes it line buffered
+ * and dropped by __srefill_r when it is found to be something else, so
+ * the list may hold closed streams but misses none that has output.
+ * If the list cannot grow, __slbf_max is set to -1 and __srefill_r
+ * walks all streams again.
+ */
+
+/*
+ * Return nonzero if FP is one of the FILEs of the global reent, as
+ * opposed to the standard streams of another reent.
+ */
+
+static int
+_DEFUN(__sfp_global, (fp),
+       FILE *fp)
+{
+  struct _glue *g;
+
+  for (g = &_GLOBAL_REENT->__sglue; g != NULL; g = g->_next)
+    if (fp >= g->_iobs && fp < g->_iobs + g->_niobs)
+      return 1;
+  return 0;
+}
+
+static FILE *__slbf_static[8];
+FILE **__slbf_list = __slbf_static;
+int __slbf_n;
+int __slbf_max = sizeof (__slbf_static) / sizeof (__slbf_static[0]);
+
+_VOID
+_DEFUN(__slbf_add, (d, fp),
+       struct _reent *d _AND
+       FILE *fp)
+{
+  FILE **list;
+  int i;
+
+  __sfp_lock_acquire ();
+  for (i = 0; i < __slbf_n; i++)
+    if (__slbf_list[i] == fp)
+      goto done;
+  /* The streams of other reents are not flushed by __srefill_r, and
+     may go away with their reent.  */
+  if (!__sfp_global (fp) || __slbf_max < 0)
+    goto done;
+  if (__slbf_n == __slbf_max)
+    {
+      list = (FILE **) _malloc_r (d, 2 * __slbf_max * sizeof (FILE *));
+      if (list == NULL)
+	{
+	  __slbf_max = -1;
+	  goto done;
+	}
+      memcpy (list, __slbf_list, __slbf_n * sizeof (FILE *));
+      if (__slbf_list != __slbf_static)
+	_free_r (d, __slbf_list);
+      __slbf_list = list;
+      __slbf_max *= 2;
+    }
+  __slbf_list[__slbf_n++] = fp;
+done:
+  __sfp_lock_release ();
+}
+
+/*
+ * The free FILEs of the global reent, linked through _cookie, so that
+ * __sfp takes one in constant time.  __sfp_free puts a released FILE
+ * at the front.  Only when the list is empty does __sfp walk the glue,
+ * collecting any FILE released without __sfp_free, and if there is
+ * none it adds a glue block as big as all the others together, so
+ * that opening N files makes only log (N) blocks.
+ */
+
+static FILE *__sfp_freelist;
+
+/*
+ * Release FP for reuse.  The caller holds the __sfp_lock.  A standard
+ * stream of another reent is not listed, as it goes away with its
+ * reent.
+ */
+
+_VOID
+_DEFUN(__sfp_free, (fp),
+       FILE *fp)
+{
+  fp->_flags = 0;
+  if (!__sfp_global (fp))
+    return;
+  fp->_cookie = __sfp_freelist;
+  __sfp_freelist = fp;
+}
+
 /*
  * Find a free FILE for fopen et al.
  */
@@ -105,27 +200,42 @@ _DEFUN(__sfp, (d),
        struct _reent *d)
 {
   FILE *fp;
-  int n;
+  int n, total;
   struct _glue *g;
 
   __sfp_lock_acquire ();
 
   if (!_GLOBAL_REENT->__sdidinit)
     __sinit (_GLOBAL_REENT);
-  for (g = &_GLOBAL_REENT->__sglue;; g = g->_next)
+  if (__sfp_freelist == NULL)
     {
-      for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
-	if (fp->_flags == 0)
-	  goto found;
-      if (g->_next == NULL &&
-	  (g->_next = __sfmoreglue (d, NDYNAMIC)) == NULL)
-	break;
+      total = 0;
+      for (g = &_GLOBAL_REENT->__sglue;; g = g->_next)
+	{
+	  for (fp = g->_iobs + g->_niobs, n = g->_niobs; --n >= 0;)
+	    if ((--fp)->_flags == 0)
+	      __sfp_free (fp);
+	  total += g->_niobs;
+	  if (g->_next == NULL)
+	    break;
+	}
+      if (__sfp_freelist == NULL)
+	{
+	  if ((g->_next = __sfmoreglue (d, total > NDYNAMIC
+					   ? total : NDYNAMIC)) == NULL)
+	    {
+	      __sfp_lock_release ();
+	      d->_errno = ENOMEM;
+	      return NULL;
+	    }
+	  g = g->_next;
+	  for (fp = g->_iobs + g->_niobs, n = g->_niobs; --n >= 0;)
+	    __sfp_free (--fp);
+	}
     }
-  __sfp_lock_release ();
-  d->_errno = ENOMEM;
-  return NULL;
+  fp = __sfp_freelist;
+  __sfp_freelist = (FILE *) fp->_cookie;
 
-found:
   fp->_file = -1;		/* no file */
   fp->_flags = 1;		/* reserve this slot; caller sets real flags */
   fp->_flags2 = 0;
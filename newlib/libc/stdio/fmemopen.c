@@ -292,7 +292,7 @@ _DEFUN(_fmemopen_r, (ptr, buf, size, mode),
       == NULL)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -220,7 +220,7 @@ _DEFUN(_fopencookie_r, (ptr, cookie, mode, functions),
   if ((c = (fccookie *) _malloc_r (ptr, sizeof *c)) == NULL)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
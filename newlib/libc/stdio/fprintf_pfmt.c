@@ -0,0 +1,49 @@
+/* doc in pfmt.c */
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include "local.h"
+
+#ifndef _REENT_ONLY
+
+int
+_DEFUN(vfprintf_pfmt, (fp, pf, ap),
+       FILE *fp          _AND
+       _CONST pfmt_t *pf _AND
+       va_list ap)
+{
+  return _vfprintf_pfmt_r (_REENT, fp, pf, ap);
+}
+
+int
+_DEFUN(fprintf_pfmt, (fp, pf),
+       FILE *fp          _AND
+       _CONST pfmt_t *pf _DOTS)
+{
+  int ret;
+  va_list ap;
+
+  va_start (ap, pf);
+  ret = _vfprintf_pfmt_r (_REENT, fp, pf, ap);
+  va_end (ap);
+  return ret;
+}
+
+int
+_DEFUN(printf_pfmt, (pf),
+       _CONST pfmt_t *pf _DOTS)
+{
+  int ret;
+  va_list ap;
+  struct _reent *ptr = _REENT;
+
+  _REENT_SMALL_CHECK_INIT (ptr);
+  va_start (ap, pf);
+  ret = _vfprintf_pfmt_r (ptr, _stdout_r (ptr), pf, ap);
+  va_end (ap);
+  return ret;
+}
+
+#endif /* !_REENT_ONLY */
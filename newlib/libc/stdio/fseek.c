@@ -173,6 +173,11 @@ _DEFUN(_fseek_r, (ptr, fp, offset, whence),
        * we have to first find the current stream offset a la
        * ftell (see ftell for details).
        */
+#ifdef _NANO_FSEEK_OPTIMIZATION
+      /* As in ftell, do not flush a read stream, which would throw
+	 away the buffer we may seek within.  */
+      if (fp->_flags & __SWR)
+#endif
       _fflush_r (ptr, fp);   /* may adjust seek offset on append stream */
       if (fp->_flags & __SOFF)
 	curoff = fp->_offset;
@@ -224,7 +229,138 @@ _DEFUN(_fseek_r, (ptr, fp, offset, whence),
   if (fp->_bf._base == NULL)
     __smakebuf_r (ptr, fp);
 
+#ifdef _NANO_FSEEK_OPTIMIZATION
+  if (fp->_flags & (__SWR | __SRW | __SNBF | __SNPT))
+    goto dumb;
+  if ((fp->_flags & __SOPT) == 0)
+    {
+      if (seekfn != __sseek
+	  || fp->_file < 0
+#ifdef __USE_INTERNAL_STAT64
+	  || _fstat64_r (ptr, fp->_file, &st)
+#else
+	  || _fstat_r (ptr, fp->_file, &st)
+#endif
+	  || (st.st_mode & S_IFMT) != S_IFREG)
+	{
+	  fp->_flags |= __SNPT;
+	  goto dumb;
+	}
+#ifdef HAVE_BLKSIZE
+      fp->_blksize = st.st_blksize <= 0 ? BUFSIZ : st.st_blksize;
+#else
+      fp->_blksize = BUFSIZ;
+#endif
+      fp->_flags |= __SOPT;
+    }
+
+  /*
+   * We are reading; we can try to optimise.
+   * Figure out where we are going and where we are now.
+   */
+
+  if (whence == SEEK_SET)
+    target = offset;
+  else
+    {
+#ifdef __USE_INTERNAL_STAT64
+      if (_fstat64_r (ptr, fp->_file, &st))
+#else
+      if (_fstat_r (ptr, fp->_file, &st))
+#endif
+	goto dumb;
+      target = st.st_size + offset;
+    }
+
+  if (!havepos)
+    {
+      if (fp->_flags & __SOFF)
+	curoff = fp->_offset;
+      else
+	{
+	  curoff = seekfn (ptr, fp->_cookie, (_fpos_t) 0, SEEK_CUR);
+	  if (curoff == POS_ERR)
+	    goto dumb;
+	}
+      curoff -= fp->_r;
+      if (HASUB (fp))
+	curoff -= fp->_ur;
+    }
+
+  /*
+   * Compute the number of bytes in the input buffer (pretending
+   * that any ungetc() input has been discarded).  Adjust current
+   * offset backwards by this count so that it represents the
+   * file offset for the first byte in the current input buffer.
+   */
+
+  if (HASUB (fp))
+    {
+      curoff += fp->_r;	/* kill off ungetc */
+      n = fp->_up - fp->_bf._base;
+      curoff -= n;
+      n += fp->_ur;
+    }
+  else
+    {
+      n = fp->_p - fp->_bf._base;
+      curoff -= n;
+      n += fp->_r;
+    }
+
+  /*
+   * If the target offset is within the current buffer,
+   * simply adjust the pointers, clear EOF, undo ungetc(),
+   * and return.
+   */
+
+  if (target >= curoff && target < curoff + (_fpos_t) n)
+    {
+      register int o = target - curoff;
+
+      fp->_p = fp->_bf._base + o;
+      fp->_r = n - o;
+      if (HASUB (fp))
+	FREEUB (ptr, fp);
+      fp->_flags &= ~__SEOF;
+      memset (&fp->_mbstate, 0, sizeof (_mbstate_t));
+      _funlockfile (fp);
+      __sfp_lock_release ();
+      return 0;
+    }
+
+  /*
+   * The place we want to get to is not within the current buffer,
+   * but we can still be kind to the kernel copyout mechanism.
+   * By aligning the file offset to a block boundary, we can let
+   * the kernel use the VM hardware to map pages instead of
+   * copying bytes laboriously.  Using a block boundary also
+   * ensures that we only read one block, rather than two.
+   */
+
+  curoff = target & ~(fp->_blksize - 1);
+  if (seekfn (ptr, fp->_cookie, curoff, SEEK_SET) == POS_ERR)
+    goto dumb;
+  fp->_r = 0;
+  fp->_p = fp->_bf._base;
+  if (HASUB (fp))
+    FREEUB (ptr, fp);
+  fp->_flags &= ~__SEOF;
+  n = target - curoff;
+  if (n)
+    {
+      if (__srefill_r (ptr, fp) || (size_t) fp->_r < n)
+	goto dumb;
+      fp->_p += n;
+      fp->_r -= n;
+    }
+  memset (&fp->_mbstate, 0, sizeof (_mbstate_t));
+  _funlockfile (fp);
+  __sfp_lock_release ();
+  return 0;
+#else
   /* We do not do fseek optimization any more, for the sake of code size. */
+#endif /* _NANO_FSEEK_OPTIMIZATION */
   /*
    * We get here if we cannot optimise the seek ... just
    * do it.  Allow the seek function to change fp->_bf._base.
@@ -251,6 +387,9 @@ dumb:
      means that a corresponding seek must not optimize.  The
      optimization is then allowed if no subsequent flush
      is performed.  */
+#ifdef _NANO_FSEEK_OPTIMIZATION
+  fp->_flags &= ~__SNPT;
+#endif
   memset (&fp->_mbstate, 0, sizeof (_mbstate_t));
   _funlockfile (fp);
   __sfp_lock_release ();
@@ -215,7 +215,7 @@ _DEFUN(_funopen_r, (ptr, cookie, readfn, writefn, seekfn, closefn),
   if ((c = (funcookie *) _malloc_r (ptr, sizeof *c)) == NULL)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -48,11 +48,15 @@ int	      _EXFUN(_svfprintf_r,(struct _reent *, FILE *, const char *,
 int	      _EXFUN(_svfiprintf_r,(struct _reent *, FILE *, const char *, 
 				  va_list)
                			_ATTRIBUTE ((__format__ (__printf__, 3, 0))));
+int	      _EXFUN(_svfprintf_pfmt_r,(struct _reent *, FILE *,
+				  const pfmt_t *, va_list));
+const char   *_EXFUN(__pfmt_parse,(pfmt_t *, const char *));
 int	      _EXFUN(_svfwprintf_r,(struct _reent *, FILE *, const wchar_t *, 
 				  va_list));
 int	      _EXFUN(_svfiwprintf_r,(struct _reent *, FILE *, const wchar_t *, 
 				  va_list));
 extern FILE  *_EXFUN(__sfp,(struct _reent *));
+extern _VOID  _EXFUN(__sfp_free,(FILE *));
 extern int    _EXFUN(__sflags,(struct _reent *,_CONST char*, int*));
 extern int    _EXFUN(__srefill_r,(struct _reent *,FILE *));
 extern _READ_WRITE_RETURN_TYPE _EXFUN(__sread,(struct _reent *, void *, char *,
@@ -68,6 +72,10 @@ extern _VOID   _EXFUN(__sinit,(struct _reent *));
 extern _VOID   _EXFUN(_cleanup_r,(struct _reent *));
 extern _VOID   _EXFUN(__smakebuf_r,(struct _reent *, FILE *));
 extern int    _EXFUN(_fwalk,(struct _reent *, int (*)(FILE *)));
+extern _VOID  _EXFUN(__slbf_add,(struct _reent *, FILE *));
+extern FILE  **__slbf_list;
+extern int    __slbf_n;
+extern int    __slbf_max;
 extern int    _EXFUN(_fwalk_reent,(struct _reent *, int (*)(struct _reent *, FILE *)));
 struct _glue * _EXFUN(__sfmoreglue,(struct _reent *,int n));
 extern int _EXFUN(__submore, (struct _reent *, FILE *));
@@ -33,7 +33,8 @@
  * As a side effect, we set __SOPT or __SNPT (en/dis-able fseek
  * optimization) right after the _fstat() that finds the buffer size.
  *
- * We do not do fseek optimization for the sake of code size.
+ * Unless _NANO_FSEEK_OPTIMIZATION is defined, we do not do fseek
+ * optimization for the sake of code size.
  */
 
 _VOID
@@ -76,6 +77,23 @@ _DEFUN(__smakebuf_r, (ptr, fp),
 #else
       size = BUFSIZ;
 #endif
+#ifdef _NANO_FSEEK_OPTIMIZATION
+      /*
+       * Optimize fseek() only if it is a regular file.
+       * (The test for __sseek is mainly paranoia.)
+       */
+      if ((st.st_mode & S_IFMT) == S_IFREG && fp->_seek == __sseek)
+	{
+	  fp->_flags |= __SOPT;
+#ifdef HAVE_BLKSIZE
+	  fp->_blksize = st.st_blksize <= 0 ? BUFSIZ : st.st_blksize;
+#else
+	  fp->_blksize = BUFSIZ;
+#endif
+	}
+      else
+	fp->_flags |= __SNPT;
+#endif /* _NANO_FSEEK_OPTIMIZATION */
     }
   if ((p = _malloc_r (ptr, size)) == NULL)
     {
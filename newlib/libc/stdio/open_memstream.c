@@ -314,7 +314,7 @@ _DEFUN(internal_open_memstream_r, (ptr, buf, size, wide),
   if ((c = (memstream *) _malloc_r (ptr, sizeof *c)) == NULL)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -337,7 +337,7 @@ _DEFUN(internal_open_memstream_r, (ptr, buf, size, wide),
   if (!*buf)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -0,0 +1,229 @@
+/*
+FUNCTION
+<<pfmt_compile>>, <<fprintf_pfmt>>, <<snprintf_pfmt>>---print with a compiled format
+
+INDEX
+	pfmt_compile
+INDEX
+	fprintf_pfmt
+INDEX
+	printf_pfmt
+INDEX
+	snprintf_pfmt
+INDEX
+	vfprintf_pfmt
+INDEX
+	vsnprintf_pfmt
+INDEX
+	_vfprintf_pfmt_r
+INDEX
+	_vsnprintf_pfmt_r
+
+ANSI_SYNOPSIS
+	#include <stdio.h>
+	int pfmt_compile(pfmt_t *<[pf]>, int <[n]>, const char *<[format]>);
+	int fprintf_pfmt(FILE *<[fd]>, const pfmt_t *<[pf]>, ...);
+	int printf_pfmt(const pfmt_t *<[pf]>, ...);
+	int snprintf_pfmt(char *<[str]>, size_t <[size]>,
+			const pfmt_t *<[pf]>, ...);
+	int vfprintf_pfmt(FILE *<[fd]>, const pfmt_t *<[pf]>, va_list <[list]>);
+	int vsnprintf_pfmt(char *<[str]>, size_t <[size]>,
+			const pfmt_t *<[pf]>, va_list <[list]>);
+
+	int _vfprintf_pfmt_r(struct _reent *<[reent]>, FILE *<[fd]>,
+			const pfmt_t *<[pf]>, va_list <[list]>);
+	int _vsnprintf_pfmt_r(struct _reent *<[reent]>, char *<[str]>,
+			size_t <[size]>, const pfmt_t *<[pf]>, va_list <[list]>);
+
+TRAD_SYNOPSIS
+	#include <stdio.h>
+	int pfmt_compile(<[pf]>, <[n]>, <[format]>)
+	pfmt_t *<[pf]>;
+	int <[n]>;
+	char *<[format]>;
+
+DESCRIPTION
+<<printf>> and friends parse their format every time they are called.
+For a format that is used over and over, such as a log message,
+<<pfmt_compile>> does the parsing once.  It stores into the array
+<[pf]> of <[n]> entries one entry for each conversion of <[format]>,
+holding its flags, field width, precision, length modifier and the
+literal text in front of it, and a last entry for the text after the
+last conversion.  The entries point into <[format]>, which must stay
+valid while they are used.
+
+<<fprintf_pfmt>>, <<printf_pfmt>>, <<snprintf_pfmt>>, <<vfprintf_pfmt>>
+and <<vsnprintf_pfmt>> print like <<fprintf>>, <<printf>>,
+<<snprintf>>, <<vfprintf>> and <<vsnprintf>> with the original format,
+taking the same arguments, but go straight from one entry to the next.
+The conversions are done by the same functions as for <<printf>>, so
+floating-point output still needs <<_printf_float>> to be linked, see
+README.nano.
+
+<<_vfprintf_pfmt_r>> and <<_vsnprintf_pfmt_r>> are reentrant versions
+taking the reentrancy structure <[reent]>.
+
+RETURNS
+<<pfmt_compile>> returns the number of entries <[format]> needs, which
+is one more than the number of its conversions.  If that is more than
+<[n]>, the entries are not usable, and a bigger array must be passed.
+It returns -1 if <[format]> has a field width or precision above 32767,
+or more than 65535 bytes of literal text in one run.
+
+The printing functions return what their counterparts with the
+original format return.
+
+PORTABILITY
+These functions are specific to newlib-nano.
+
+Supporting OS subroutines required: <<close>>, <<fstat>>, <<isatty>>,
+<<lseek>>, <<read>>, <<sbrk>>, <<write>>.
+*/
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdarg.h>
+#include "local.h"
+#include "vfprintf_local.h"
+
+/* Parse the literal text at FMT and the conversion after it, as
+   _VFPRINTF_R does, into PF.  Return where the next entry starts, or
+   NULL if a width, precision or literal run is too big for PF.  */
+_CONST char *
+_DEFUN(__pfmt_parse, (pf, fmt),
+       pfmt_t *pf _AND
+       _CONST char *fmt)
+{
+	int flags, width, prec, len;
+
+	pf->_lit = fmt;
+	while (*fmt != '\0' && *fmt != '%')
+		fmt++;
+	if (fmt - pf->_lit > USHRT_MAX)
+		return NULL;
+	pf->_litlen = fmt - pf->_lit;
+	flags = 0;
+	width = 0;
+	prec = -1;
+	pf->_sign = '\0';
+	pf->_code = '\0';
+	if (*fmt == '%') {
+		fmt++;
+		/* A switch rather than memchr on "#-0+ ", as the string
+		   functions are not inlined in the library.  */
+		for (;; fmt++) {
+			switch (*fmt) {
+			case '#':
+				flags |= ALT;
+				continue;
+			case '-':
+				flags |= LADJUST;
+				continue;
+			case '0':
+				flags |= ZEROPAD;
+				continue;
+			case '+':
+				flags |= PLUSSGN;
+				continue;
+			case ' ':
+				flags |= SPACESGN;
+				continue;
+			}
+			break;
+		}
+		if (flags & SPACESGN)
+			pf->_sign = ' ';
+		if (flags & PLUSSGN)
+			pf->_sign = '+';
+
+		if (*fmt == '*') {
+			width = -1;
+			fmt++;
+		}
+		else {
+			for (; is_digit (*fmt); fmt++)
+				if ((width = 10 * width
+				     + to_digit (*fmt)) > SHRT_MAX)
+					return NULL;
+		}
+
+		if (*fmt == '.') {
+			fmt++;
+			if (*fmt == '*') {
+				prec = -2;
+				fmt++;
+			}
+			else {
+				prec = 0;
+				for (; is_digit (*fmt); fmt++)
+					if ((prec = 10 * prec
+					     + to_digit (*fmt)) > SHRT_MAX)
+						return NULL;
+			}
+		}
+
+		switch (*fmt) {
+		case 'h':
+			len = SHORTINT;
+			break;
+		case 'l':
+			len = LONGINT;
+			break;
+		case 'L':
+			len = LONGDBL;
+			break;
+		case 'z':
+			len = SIZEINT_FLAGS;
+			break;
+		case 'j':
+			len = MAXINT_FLAGS;
+			break;
+		case 't':
+			len = PTRINT_FLAGS;
+			break;
+		default:
+			len = -1;
+			break;
+		}
+		if (len != -1) {
+			fmt++;
+			/* hh and ll */
+			if (*fmt == fmt[-1] && (*fmt == 'h' || *fmt == 'l')) {
+				len = (*fmt == 'h') ? CHARINT : LLINT_FLAGS;
+				fmt++;
+			}
+			flags |= len;
+		}
+
+		/* A conversion cut short by the end of the format is
+		   dropped.  */
+		if ((pf->_code = *fmt) != '\0')
+			fmt++;
+	}
+	pf->_flags = flags;
+	pf->_width = width;
+	pf->_prec = prec;
+	return fmt;
+}
+
+int
+_DEFUN(pfmt_compile, (pf, n, format),
+       pfmt_t *pf _AND
+       int n _AND
+       _CONST char *format)
+{
+	pfmt_t last, *p;
+	int i;
+
+	/* Entries beyond N are parsed into LAST, only to count them.  */
+	for (i = 0;; i++) {
+		p = i < n ? &pf[i] : &last;
+		if ((format = __pfmt_parse (p, format)) == NULL)
+			return -1;
+		if (p->_code == '\0')
+			return i + 1;
+	}
+}
@@ -31,6 +31,36 @@ _DEFUN(lflush, (fp),
   return 0;
 }
 
+/*
+ * Flush the line buffered output streams listed by __slbf_add, dropping
+ * those that are no longer line buffered output streams.
+ */
+
+static _VOID
+_DEFUN_VOID(lflush_all)
+{
+  FILE *fp;
+  int i, n;
+
+  if (__slbf_max < 0)
+    {
+      _CAST_VOID _fwalk (_GLOBAL_REENT, lflush);
+      return;
+    }
+  __sfp_lock_acquire ();
+  for (i = n = 0; i < __slbf_n; i++)
+    {
+      fp = __slbf_list[i];
+      if ((fp->_flags & (__SLBF | __SWR)) != (__SLBF | __SWR))
+	continue;
+      __slbf_list[n++] = fp;
+      if (fp->_file != -1)
+	_CAST_VOID fflush (fp);
+    }
+  __slbf_n = n;
+  __sfp_lock_release ();
+}
+
 /*
  * Refill a stdio buffer.
  * Return EOF on eof or error, 0 otherwise.
@@ -102,7 +132,7 @@ _DEFUN(__srefill_r, (ptr, fp),
    */
 
   if (fp->_flags & (__SLBF | __SNBF))
-    _CAST_VOID _fwalk (_GLOBAL_REENT, lflush);
+    lflush_all ();
   fp->_p = fp->_bf._base;
   fp->_r = fp->_read (ptr, fp->_cookie, (char *) fp->_p, fp->_bf._size);
 #ifndef __CYGWIN__
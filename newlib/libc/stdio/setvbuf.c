@@ -176,6 +176,7 @@ nbf:
     case _IOLBF:
       fp->_flags |= __SLBF;
       fp->_lbfsize = buf ? -size : 0;
+      __slbf_add (_REENT, fp);
       /* FALLTHROUGH */
 
     case _IOFBF:
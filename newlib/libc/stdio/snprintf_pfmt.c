@@ -0,0 +1,66 @@
+/* doc in pfmt.c */
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <errno.h>
+#include "local.h"
+
+int
+_DEFUN(_vsnprintf_pfmt_r, (ptr, str, size, pf, ap),
+       struct _reent *ptr _AND
+       char *str          _AND
+       size_t size        _AND
+       _CONST pfmt_t *pf  _AND
+       va_list ap)
+{
+  int ret;
+  FILE f;
+
+  if (size > INT_MAX)
+    {
+      ptr->_errno = EOVERFLOW;
+      return EOF;
+    }
+  f._flags = __SWR | __SSTR;
+  f._bf._base = f._p = (unsigned char *) str;
+  f._bf._size = f._w = (size > 0 ? size - 1 : 0);
+  f._file = -1;  /* No file. */
+  ret = _svfprintf_pfmt_r (ptr, &f, pf, ap);
+  if (ret < EOF)
+    ptr->_errno = EOVERFLOW;
+  if (size > 0)
+    *f._p = 0;
+  return ret;
+}
+
+#ifndef _REENT_ONLY
+
+int
+_DEFUN(vsnprintf_pfmt, (str, size, pf, ap),
+       char *str         _AND
+       size_t size       _AND
+       _CONST pfmt_t *pf _AND
+       va_list ap)
+{
+  return _vsnprintf_pfmt_r (_REENT, str, size, pf, ap);
+}
+
+int
+_DEFUN(snprintf_pfmt, (str, size, pf),
+       char *str         _AND
+       size_t size       _AND
+       _CONST pfmt_t *pf _DOTS)
+{
+  int ret;
+  va_list ap;
+
+  va_start (ap, pf);
+  ret = _vsnprintf_pfmt_r (_REENT, str, size, pf, ap);
+  va_end (ap);
+  return ret;
+}
+
+#endif /* !_REENT_ONLY */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2012 ARM Ltd
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the company may not be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Arithmetic on small unsigned integers of N 32 bit words, least
+   significant word first, for the float only conversions of
+   _printf_float32 and _scanf_float32.  Every float is a 24 bit integer
+   times a power of two between 2^-149 and 2^104, so a few words on the
+   stack hold it exactly and no _dtoa_r or _strtod_r is needed.  Only
+   32x32->64 bit multiplication and 32 bit division are used.  */
+
+#ifndef _VFLOAT32_H_
+#define _VFLOAT32_H_
+
+#include <stdint.h>
+
+/* Most significant digits the exact decimal value of a float has.  */
+#define FLOAT32_DIG	112
+
+/* Set X to X * MUL + ADD modulo 2^(32 * N) and return the carry out
+   of the top word.  */
+static __uint32_t
+f32_muladd (__uint32_t *x, int n, __uint32_t mul, __uint32_t add)
+{
+	uint64_t t;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		t = (uint64_t) x[i] * mul + add;
+		x[i] = (__uint32_t) t;
+		add = (__uint32_t) (t >> 32);
+	}
+	return add;
+}
+
+/* Divide X by D, which must be below 2^16, and return the remainder.
+   The division goes by halfwords so that the dividend fits a 32 bit
+   division.  */
+static __uint32_t
+f32_div (__uint32_t *x, int n, __uint32_t d)
+{
+	__uint32_t r = 0, hi, lo;
+
+	while (--n >= 0) {
+		hi = (r << 16) | (x[n] >> 16);
+		r = hi % d;
+		lo = (r << 16) | (x[n] & 0xffff);
+		r = lo % d;
+		x[n] = ((hi / d) << 16) | (lo / d);
+	}
+	return r;
+}
+
+/* Return N without the most significant zero words of X.  */
+static int
+f32_trim (__uint32_t *x, int n)
+{
+	while (n > 0 && x[n - 1] == 0)
+		n--;
+	return n;
+}
+
+#endif /* _VFLOAT32_H_ */
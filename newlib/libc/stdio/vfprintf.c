@@ -176,73 +176,9 @@ static char *rcsid = "$Id: vfprintf.c,v 1.43 2002/08/13 02:40:06 fitzsim Exp $";
 
 #include "vfprintf_local.h"
 
-/* The __ssputc_r function is shared between all versions of
-   vfprintf and vfwprintf. */
 #ifdef STRING_ONLY
-int
-_DEFUN(__ssputc_r, (ptr, c, fp),
-       struct _reent *ptr _AND
-       int c _AND
-       FILE *fp)
-{
-	if (fp->_w == 0 && fp->_flags & (__SMBF | __SOPT)) {
-		/* must be asprintf family */
-		unsigned char *str;
-		int curpos = (fp->_p - fp->_bf._base);
-		/* Choose a geometric growth factor to avoid
-	 	 * quadratic realloc behavior, but use a rate less
-		 * than (1+sqrt(5))/2 to accomodate malloc
-	 	 * overhead. asprintf EXPECTS us to overallocate, so
-	 	 * that it can add a trailing \0 without
-	 	 * reallocating.  The new allocation should thus be
-	 	 * max(prev_size*1.5, curpos+len+1), while 'len == 1'. */
-		int newsize = fp->_bf._size * 3 / 2;
-		if (newsize < curpos + 2)
-			newsize = curpos + 2;
-		if (fp->_flags & __SOPT)
-		{
-			/* asnprintf leaves original buffer alone.  */
-			str = (unsigned char *)_malloc_r (ptr, newsize);
-			if (!str)
-			{
-				ptr->_errno = ENOMEM;
-				goto err;
-			}
-			memcpy (str, fp->_bf._base, curpos);
-			fp->_flags = (fp->_flags & ~__SOPT) | __SMBF;
-		}
-		else
-		{
-			str = (unsigned char *)_realloc_r (ptr, fp->_bf._base,
-					newsize);
-			if (!str) {
-				/* Free unneeded buffer.  */
-				_free_r (ptr, fp->_bf._base);
-				/* Ensure correct errno, even if free
-				 * changed it.  */
-				ptr->_errno = ENOMEM;
-				goto err;
-			}
-		}
-		fp->_bf._base = str;
-		fp->_p = str + curpos;
-		fp->_bf._size = newsize;
-		fp->_w = newsize - curpos;
-	}
-
-        if (fp->_w > 0)
-        {
-            *fp->_p++ = (char)c;
-	    fp->_w -= 1;
-        }
-	return 0;
-
-err:
-  fp->_flags |= __SERR;
-  return EOF;
-}
 /* __ssprint_r is the original implementation of __SPRINT.
- * In newlib-nano it is reimplemented as __ssputc_r for non-wide char output,
+ * In newlib-nano it is reimplemented as __ssputs_r for non-wide char output,
  * but __ssprint_r cannot be discarded because it is used by a serial of
  * functions like svfwprintf for wide char output.  */
 int
@@ -336,8 +272,34 @@ err:
   uio->uio_iovcnt = 0;
   return EOF;
 }
+
+/* The __ssputs_r function is shared between all versions of
+   vfprintf for strings.  It copies whole spans into the buffer,
+   leaving the cases where the buffer is too small to __ssprint_r.  */
+int
+_DEFUN(__ssputs_r, (ptr, fp, buf, len),
+       struct _reent *ptr _AND
+       FILE *fp _AND
+       _CONST char *buf _AND
+       size_t len)
+{
+	struct __suio uio;
+	struct __siov iov;
+
+	if ((int) len < fp->_w) {
+		memcpy (fp->_p, buf, len);
+		fp->_p += len;
+		fp->_w -= len;
+		return 0;
+	}
+	iov.iov_base = buf;
+	iov.iov_len = uio.uio_resid = len;
+	uio.uio_iov = &iov;
+	uio.uio_iovcnt = 1;
+	return __ssprint_r (ptr, fp, &uio);
+}
 #else
-/* As __ssputc_r, __sprint_r is used by output functions for wide char,
+/* As __ssprint_r, __sprint_r is used by output functions for wide char,
  * like vfwprint.  */
 /*
  * Flush out all the vectors defined by the given uio,
@@ -380,15 +342,44 @@ out:
 	return (err);
 }
 
-_DEFUN(__sfputc_r, (ptr, c, fp),
+/* Write a span of LEN bytes to FP.  Spans that fit in the buffer are
+   copied directly, and a line buffered stream is flushed after a span
+   holding a newline.  The others go through __sfvwrite_r, which writes
+   to unbuffered streams once per span.  */
+int
+_DEFUN(__sfputs_r, (ptr, fp, buf, len),
        struct _reent *ptr _AND
-       int c _AND
-       FILE *fp)
+       FILE *fp _AND
+       _CONST char *buf _AND
+       size_t len)
 {
-	if (--fp->_w >= 0 || (fp->_w >= fp->_lbfsize && (char)c != '\n'))
-		return (*fp->_p++ = c);
-	else
-		return (__swbuf_r(ptr, c, fp));
+	struct __suio uio;
+	struct __siov iov;
+	size_t i;
+	int nl;
+
+#ifndef __SCLE
+	if ((fp->_flags & __SLBF) == 0) {
+		if ((int) len <= fp->_w) {
+			memcpy (fp->_p, buf, len);
+			fp->_p += len;
+			fp->_w -= len;
+			return 0;
+		}
+	} else if ((int) len < fp->_bf._size + fp->_w) {
+		/* Spans are short, so look for the newline while copying.  */
+		for (i = nl = 0; i < len; i++)
+			if ((*fp->_p++ = buf[i]) == '\n')
+				nl = 1;
+		fp->_w -= len;
+		return nl ? _fflush_r (ptr, fp) : 0;
+	}
+#endif
+	iov.iov_base = buf;
+	iov.iov_len = uio.uio_resid = len;
+	uio.uio_iov = &iov;
+	uio.uio_iovcnt = 1;
+	return __sfvwrite_r (ptr, fp, &uio);
 }
 #endif /* STRING_ONLY */
 
@@ -413,9 +404,9 @@ _EXFUN(vfiprintf, (FILE *, const char *, __VALIST)
 #endif /* STRING_ONLY */
 
 #ifdef STRING_ONLY
-# define __SPRINT __ssputc_r
+# define __SPRINT __ssputs_r
 #else
-# define __SPRINT __sfputc_r
+# define __SPRINT __sfputs_r
 #endif
 
 /* do not need FLUSH for all sprintf functions */
@@ -426,18 +417,24 @@ _EXFUN(vfiprintf, (FILE *, const char *, __VALIST)
 #endif
 
 int
-_DEFUN(_VFPRINTF_R, (data, fp, fmt0, ap),
+_DEFUN(_VFPRINTF_R, (data, fp, fmt0, ap0),
        struct _reent *data _AND
        FILE * fp           _AND
        _CONST char *fmt0   _AND
-       va_list ap)
+       va_list ap0)
 {
 	register char *fmt;	/* format string */
 	register int n, m;	/* handy integers (short term usage) */
 	register char *cp;	/* handy char pointer (short term usage) */
 	const char *flag_chars;
+	static _CONST int length_flags[] = {
+		SHORTINT, LONGINT, LONGDBL,
+		SIZEINT_FLAGS, MAXINT_FLAGS, PTRINT_FLAGS
+	};
 	struct _prt_data_t prt_data;	/* all data for decoding format string */
-	int (*pfunc)(struct _reent *, int, FILE *);	/* output function pointer */
+	/* output function pointer */
+	int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t);
+	va_list ap;	/* argument list, passed on by address */
 
 	pfunc = __SPRINT;
 
@@ -464,6 +461,10 @@ _DEFUN(_VFPRINTF_R, (data, fp, fmt0, ap),
 	}
 #endif /* STRING_ONLY */
 
+	/* The conversion functions take a pointer to the argument list.
+	   Where va_list is an array type, &ap0 would point to the decayed
+	   parameter instead, so pass the address of a local copy.  */
+	va_copy (ap, ap0);
 	fmt = (char *)fmt0;
 	prt_data.ret = 0;
 	prt_data.blank = ' ';
@@ -550,32 +551,21 @@ _DEFUN(_VFPRINTF_R, (data, fp, fmt0, ap),
 		}
 
 		/***** The length modifiers. *****/
-		flag_chars = "hlL";
-		if (cp = memchr (flag_chars, *fmt, 3)) {
-			prt_data.flags |= (SHORTINT << (cp - flag_chars));
+		flag_chars = "hlLzjt";
+		if (cp = memchr (flag_chars, *fmt, 6)) {
 			fmt++;
+			/* hh and ll */
+			if (*fmt == *cp && cp < flag_chars + 2) {
+				prt_data.flags |= (*cp == 'h') ? CHARINT : LLINT_FLAGS;
+				fmt++;
+			}
+			else
+				prt_data.flags |= length_flags[cp - flag_chars];
 		}
 
 		/***** The conversion specifiers. *****/
 		prt_data.code = *fmt++;
-		cp = memchr ("efgEFG", prt_data.code, 6);
-#ifdef FLOATING_POINT
-		/* If cp is not NULL, we are facing FLOATING POINT NUMBER.  */
-		if (cp) {
-			/* Consume floating point argument if _printf_float is not linked.  */
-			if (_printf_float == NULL) {
-				if (prt_data.flags & LONGDBL)
-					GET_ARG (N, ap, _LONG_DOUBLE);
-				else
-					GET_ARG (N, ap, double);
-			}
-			else {
-				n = _printf_float (data, &prt_data, fp, pfunc, &ap);
-			}
-		}
-		else
-#endif
-			n = _printf_i (data, &prt_data, fp, pfunc, &ap);
+		n = _printf_conv (data, &prt_data, fp, pfunc, &ap);
 		if (n == -1)
 			goto error;
 		prt_data.ret += n;
@@ -583,6 +573,7 @@ _DEFUN(_VFPRINTF_R, (data, fp, fmt0, ap),
 done:
 	FLUSH ();
 error:
+	va_end (ap);
 #ifndef STRING_ONLY
 	_funlockfile (fp);
 #endif
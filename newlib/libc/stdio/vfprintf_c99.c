@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2012 ARM Ltd
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the company may not be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <newlib.h>
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <wchar.h>
+#include <sys/lock.h>
+#include <stdarg.h>
+#include "local.h"
+#include "../stdlib/local.h"
+#include "fvwrite.h"
+#include "vfieeefp.h"
+
+#include "vfprintf_local.h"
+
+/* Fetch an argument with a C99 length modifier.  */
+#define	SARG_C99(flags) \
+	(flags&(LLINT|MAXINT) ? (long long)GET_ARG (N, (*ap), intmax_t) : \
+	    flags&SIZEINT ? (long long)(_ssize_t)GET_ARG (N, (*ap), size_t) : \
+	    (long long)GET_ARG (N, (*ap), ptrdiff_t))
+#define	UARG_C99(flags) \
+	(flags&(LLINT|MAXINT) ? (unsigned long long)GET_ARG (N, (*ap), uintmax_t) : \
+	    flags&SIZEINT ? (unsigned long long)GET_ARG (N, (*ap), size_t) : \
+	    (unsigned long long)(size_t)GET_ARG (N, (*ap), ptrdiff_t))
+
+/* Decode and print integers given with the ll, z, j or t length
+   modifiers for a type wider than long.  The format parsers send the
+   narrower ones to _printf_i, and everything else is passed on to it
+   here.  */
+int
+_printf_c99 (struct _reent *data, struct _prt_data_t *pdata, FILE *fp,
+	     int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	     va_list *ap)
+{
+	int realsz;		/* field size expanded by dprec */
+	unsigned long long _uquad;
+	u_long _ulong;
+	int base;
+	int n;
+	char *cp = pdata->buf + BUF;
+	char *xdigs = "0123456789ABCDEF";
+
+	switch (pdata->code) {
+	case 'd':
+	case 'i':
+		_uquad = SARG_C99 (pdata->flags);
+		if ((long long) _uquad < 0) {
+			_uquad = -_uquad;
+			pdata->l_buf[0] = '-';
+		}
+		base = 10;
+		goto number;
+	case 'u':
+	case 'o':
+		_uquad = UARG_C99 (pdata->flags);
+		base = (pdata->code == 'o') ? 8 : 10;
+		goto nosign;
+	case 'X':
+		pdata->l_buf[2] = 'X';
+		goto hex;
+	case 'x':
+		pdata->l_buf[2] = 'x';
+		xdigs = "0123456789abcdef";
+hex:
+		_uquad = UARG_C99 (pdata->flags);
+		base = 16;
+		if ((pdata->flags & ALT) && _uquad != 0)
+			pdata->flags |= HEXPREFIX;
+nosign:
+		pdata->l_buf[0] = '\0';
+number:
+		if ((pdata->dprec = pdata->prec) >= 0)
+			pdata->flags &= ~ZEROPAD;
+		if (_uquad != 0 || pdata->prec != 0) {
+			if (base == 10) {
+				/* Split off nine digits at a time with one
+				   long long division, so that the rest can be
+				   done in the native word size.  */
+				while (_uquad > ULONG_MAX) {
+					_ulong = _uquad % 1000000000;
+					_uquad /= 1000000000;
+					for (n = 0; n < 9; n++) {
+						*--cp = to_char (_ulong % 10);
+						_ulong /= 10;
+					}
+				}
+				_ulong = _uquad;
+				do {
+					*--cp = to_char (_ulong % 10);
+					_ulong /= 10;
+				} while (_ulong);
+			} else {
+				n = (base == 16) ? 4 : 3;
+				do {
+					*--cp = xdigs[_uquad & (base - 1)];
+					_uquad >>= n;
+				} while (_uquad);
+			}
+		}
+		pdata->size = pdata->buf + BUF - cp;
+		if (base == 8 && (pdata->flags & ALT) && pdata->dprec <= pdata->size
+		    && (pdata->size == 0 || *cp != '0'))
+			pdata->dprec = pdata->size + 1;
+		break;
+	case 'n':
+		if (pdata->flags & (LLINT | MAXINT))
+			*GET_ARG (N, *ap, intmax_t *) = pdata->ret;
+		else if (pdata->flags & SIZEINT)
+			*GET_ARG (N, *ap, size_t *) = pdata->ret;
+		else
+			*GET_ARG (N, *ap, ptrdiff_t *) = pdata->ret;
+		return 0;
+	default:
+		pdata->flags &= ~C99INT;
+		return _printf_i (data, pdata, fp, pfunc, ap);
+	}
+
+	/***** output. *****/
+	n = _printf_common (data, pdata, &realsz, fp, pfunc);
+	if (n == -1)
+		goto error;
+
+	PRINT (cp, pdata->size);
+	/* left-adjusting padding (always blank) */
+	if (pdata->flags & LADJUST)
+		PAD (pdata->width - realsz, pdata->blank);
+
+	return (pdata->width > realsz ? pdata->width : realsz);
+error:
+	return -1;
+}
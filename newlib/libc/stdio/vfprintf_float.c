@@ -53,25 +53,330 @@
 
 #include "vfprintf_local.h"
 
+#ifdef FLOAT32
+#include "vfloat32.h"
+# define _PRINTF_FLOAT	_printf_float32
+# define __cvt		__cvt32
+# define __exponent	__exponent32
+#else
+# define _PRINTF_FLOAT	_printf_float
+#endif
+
 char *
 __cvt(struct _reent *data, _PRINTF_FLOAT_TYPE value, int ndigits, int flags,
-      char *sign, int *decpt, int ch, int *length, char *buf);
+      char *sign, int *decpt, int ch, int *length, char *buf, char **end);
 
 int
 __exponent(char *p0, int exp, int fmtch);
 
 #ifdef FLOATING_POINT
 
+#if !defined(PREFER_SIZE_OVER_SPEED) && !defined(__OPTIMIZE_SIZE__) \
+    && !defined(_DOUBLE_IS_32BITS) && !defined(FLOAT32)
+/* Most conversions ask for few enough digits to be done exactly in 64 bit
+   integer arithmetic, without the multiple precision code of _dtoa_r.  */
+#define FAST_CVT
+
+/* Most digits the fast path produces, and largest power of ten it
+   scales by.  */
+#define FAST_CVT_DIGITS	19
+
+static _CONST uint64_t tens[FAST_CVT_DIGITS + 1] = {
+	1ULL,
+	10ULL,
+	100ULL,
+	1000ULL,
+	10000ULL,
+	100000ULL,
+	1000000ULL,
+	10000000ULL,
+	100000000ULL,
+	1000000000ULL,
+	10000000000ULL,
+	100000000000ULL,
+	1000000000000ULL,
+	10000000000000ULL,
+	100000000000000ULL,
+	1000000000000000ULL,
+	10000000000000000ULL,
+	100000000000000000ULL,
+	1000000000000000000ULL,
+	10000000000000000000ULL
+};
+
+/* Set *HI and *LO to the high and low halves of A * B.  */
+static void
+mul64 (uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+	uint64_t al = (__uint32_t) a, ah = a >> 32;
+	uint64_t bl = (__uint32_t) b, bh = b >> 32;
+	uint64_t ll = al * bl, lh = al * bh, hl = ah * bl;
+	uint64_t mid = (ll >> 32) + (__uint32_t) lh + (__uint32_t) hl;
+
+	*lo = (mid << 32) | (__uint32_t) ll;
+	*hi = ah * bh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+}
+
+/* Set *T to M * 2^E * 10^N rounded down, and *Q to it rounded to the
+   nearest integer, ties to even, as _dtoa_r rounds.  M must be less than
+   2^53 and N between -FAST_CVT_DIGITS and FAST_CVT_DIGITS.  Return 0 if
+   the result does not fit in 64 bits.  */
+static int
+scale10 (uint64_t m, int e, int n, uint64_t *t, uint64_t *q)
+{
+	uint64_t hi, lo, rh, rl, hh, hl;
+	int s;
+
+	if (n >= 0) {
+		/* M * 5^N * 2^(E + N), with 5^N < 2^45 */
+		mul64 (m, tens[n] >> n, &hi, &lo);
+		s = -(e + n);
+		if (s <= 0) {
+			s = -s;
+			if (hi != 0 || s > 63 || (s && lo >> (64 - s) != 0))
+				return 0;
+			*t = *q = lo << s;
+			return 1;
+		}
+		if (s > 98) {
+			/* The product is below 2^98, so under one half */
+			*t = *q = 0;
+			return 1;
+		}
+		/* Split off the remainder RH:RL of the division by 2^S,
+		   and set HH:HL to one half.  */
+		if (s < 64) {
+			if (hi >> s != 0)
+				return 0;
+			*t = (lo >> s) | (hi << (64 - s));
+			rh = 0;
+			rl = lo & (((uint64_t) 1 << s) - 1);
+			hh = 0;
+			hl = (uint64_t) 1 << (s - 1);
+		} else {
+			*t = hi >> (s - 64);
+			rh = hi & (((uint64_t) 1 << (s - 64)) - 1);
+			rl = lo;
+			hh = s == 64 ? 0 : (uint64_t) 1 << (s - 65);
+			hl = s == 64 ? (uint64_t) 1 << 63 : 0;
+		}
+	} else {
+		/* Divide the integer part of M * 2^E by 10^-N.  The
+		   fraction only matters when the remainder is one half.  */
+		if (e >= 0) {
+			if (e > 10)
+				return 0;
+			hi = m << e;
+			lo = 0;
+		} else {
+			hi = m >> -e;
+			lo = m & (((uint64_t) 1 << -e) - 1);
+		}
+		*t = hi / tens[-n];
+		rh = hi % tens[-n];
+		rl = lo != 0;
+		hh = tens[-n] / 2;
+		hl = 0;
+	}
+	if (rh > hh || (rh == hh && (rl > hl || (rl == hl && (*t & 1)))))
+		*q = *t + 1;
+	else
+		*q = *t;
+	return *q >= *t;
+}
+
+/* Put into BUF the digits _dtoa_r returns for positive VALUE in MODE 2
+   or 3 with NDIGITS, and set *DECPT as it does.  Return the number of
+   digits, or -1 if VALUE or NDIGITS is out of the range handled here.  */
+static int
+fast_cvt (_PRINTF_FLOAT_TYPE value, int mode, int ndigits, int *decpt,
+	  char *buf)
+{
+	union double_union u;
+	uint64_t m, t, q;
+	int e, k, n;
+	char *cp, *end;
+
+	u.d = value;
+	e = (word0 (u) & Exp_mask) >> Exp_shift;
+	if (e == 0 || ndigits > FAST_CVT_DIGITS)
+		return -1;
+	m = (uint64_t) ((word0 (u) & Frac_mask) | Exp_msk1) << 32 | word1 (u);
+	e -= Bias + P - 1;
+
+	if (mode == 3) {
+		if (!scale10 (m, e, ndigits, &t, &q))
+			return -1;
+		k = ndigits;
+	} else {
+		/* VALUE is in [2^(E+P-1), 2^(E+P)).  Guess the decimal
+		   exponent from that and correct the guess.  */
+		n = e + P - 1;
+		k = n >= 0 ? (n * 78913) >> 18 : -((-n * 78913 + 262143) >> 18);
+		for (;;) {
+			n = ndigits - 1 - k;
+			if (n > FAST_CVT_DIGITS || n < -FAST_CVT_DIGITS
+			    || !scale10 (m, e, n, &t, &q))
+				return -1;
+			if (t >= tens[ndigits])
+				k++;
+			else if (t < tens[ndigits - 1])
+				k--;
+			else
+				break;
+		}
+		if (q == tens[ndigits]) {
+			q = tens[ndigits - 1];
+			n--;
+		}
+		k = n;
+	}
+
+	/* Q holds the digits, K of them after the decimal point.  */
+	end = cp = buf + FAST_CVT_DIGITS + 1;
+	for (; q != 0; q /= 10)
+		*--cp = to_char (q % 10);
+	*decpt = end - cp - k;
+	/* _dtoa_r strips trailing zeros.  */
+	while (end > cp && end[-1] == '0')
+		end--;
+	for (n = 0; cp < end; n++)
+		buf[n] = *cp++;
+	buf[n] = '\0';
+	return n;
+}
+#endif /* FAST_CVT */
+
+#ifdef FLOAT32
+/* Put into BUF the digits _dtoa_r would return for positive VALUE in
+   MODE 2 or 3 with NDIGITS, and set *DECPT as it does.  The integer part
+   of VALUE, of up to 128 bits, and its fraction, of up to 149 bits, are
+   converted exactly, so this never needs more than FLOAT32_DIG digits.
+   Return the number of digits.  */
+static int
+digits32 (float value, int mode, int ndigits, int *decpt, char *buf)
+{
+	union { float f; __uint32_t i; } u;
+	__uint32_t ip[5], fp[5];	/* integer part and fraction * 2^160 */
+	__uint32_t m, r;
+	char ibuf[40], *cp;
+	int e, i, n, ni, lo, fd, d, rest;
+
+	u.f = value;
+	e = u.i >> 23;
+	m = u.i & 0x7fffff;
+	if (e == 0)
+		e = 1;
+	else
+		m |= 0x800000;
+	e -= 150;		/* VALUE is M * 2^E */
+
+	/* Convert the integer part into IBUF, four digits at a time if it
+	   does not fit a word.  */
+	cp = ibuf + sizeof (ibuf);
+	if (e < 0) {
+		for (r = -e < 24 ? m >> -e : 0; r != 0; r /= 10)
+			*--cp = to_char (r % 10);
+	} else {
+		memset (ip, 0, sizeof (ip));
+		ip[e >> 5] = m << (e & 31);
+		if ((e & 31) > 8)
+			ip[(e >> 5) + 1] = m >> (32 - (e & 31));
+		n = f32_trim (ip, 5);
+		while (n > 0) {
+			r = f32_div (ip, n, 10000);
+			n = f32_trim (ip, n);
+			for (i = 0; i < 4 && (n > 0 || r != 0); i++) {
+				*--cp = to_char (r % 10);
+				r /= 10;
+			}
+		}
+	}
+	ni = ibuf + sizeof (ibuf) - cp;
+	*decpt = ni;
+
+	/* FP[LO] is the lowest nonzero word of the fraction, LO is 5 once
+	   it is zero.  */
+	lo = 5;
+	if (e < 0) {
+		if (-e < 24)
+			m &= ((__uint32_t) 1 << -e) - 1;
+		if (m != 0) {
+			memset (fp, 0, sizeof (fp));
+			i = 160 + e;
+			lo = i >> 5;
+			fp[lo] = m << (i & 31);
+			if ((i & 31) > 8 && lo < 4)
+				fp[lo + 1] = m >> (32 - (i & 31));
+		}
+	}
+
+	if (mode == 2 && ni > ndigits) {
+		/* Rounds within the integer part.  */
+		memcpy (buf, cp, ndigits);
+		n = ndigits;
+		d = cp[n] - '0';
+		rest = lo < 5;
+		for (i = n + 1; i < ni; i++)
+			rest |= cp[i] != '0';
+	} else {
+		memcpy (buf, cp, ni);
+		n = ni;
+		/* FD counts the fraction digits, zeros before the first
+		   significant one are not stored.  */
+		for (fd = 0; lo < 5 && (mode == 3 ? fd < ndigits : n < ndigits);
+		     fd++) {
+			if (n == 0 && fp[4] == 0
+			    && (mode == 2 || fd + 9 <= ndigits)) {
+				/* Skip nine leading zeros at once.  */
+				f32_muladd (fp + lo, 5 - lo, 1000000000, 0);
+				fd += 8;
+				*decpt -= 9;
+			} else {
+				d = f32_muladd (fp + lo, 5 - lo, 10, 0);
+				if (n == 0 && d == 0)
+					--*decpt;
+				else
+					buf[n++] = to_char (d);
+			}
+			while (lo < 5 && fp[lo] == 0)
+				lo++;
+		}
+		d = lo < 5 ? f32_muladd (fp + lo, 5 - lo, 10, 0) : 0;
+		while (lo < 5 && fp[lo] == 0)
+			lo++;
+		rest = lo < 5;
+	}
+
+	/* Round the exact value half to even, as _dtoa_r does.  */
+	if (d > 5 || (d == 5 && (rest || (n > 0 && (buf[n - 1] & 1))))) {
+		while (n > 0 && buf[n - 1] == '9')
+			n--;
+		if (n == 0) {
+			buf[n++] = '1';
+			++*decpt;
+		} else
+			buf[n - 1]++;
+	}
+	while (n > 0 && buf[n - 1] == '0')
+		n--;
+	buf[n] = '\0';
+	return n;
+}
+#endif /* FLOAT32 */
+
 /* Using reentrant DATA, convert finite VALUE into a string of digits
    with no decimal point, using NDIGITS precision and FLAGS as guides
    to whether trailing zeros must be included.  Set *SIGN to nonzero
    if VALUE was negative.  Set *DECPT to the exponent plus one.  Set
    *LENGTH to the length of the returned string.  CH must be one of
    [aAeEfFgG]; if it is [aA], then the return string lives in BUF,
-   otherwise the return value shares the mprec reentrant storage.  */
+   otherwise the return value shares the mprec reentrant storage.  Only
+   the digits up to *END are stored, the rest of the *LENGTH digits are
+   trailing zeros.  */
 char *
 __cvt(struct _reent *data, _PRINTF_FLOAT_TYPE value, int ndigits, int flags,
-      char *sign, int *decpt, int ch, int *length, char *buf)
+      char *sign, int *decpt, int ch, int *length, char *buf, char **end)
 {
 	int mode, dsgn;
 	char *digits, *bp, *rve;
@@ -97,7 +402,27 @@ __cvt(struct _reent *data, _PRINTF_FLOAT_TYPE value, int ndigits, int flags,
 		mode = 2;		/* ndigits significant digits */
 	}
 
+#ifdef FLOAT32
+	digits = buf;
+	if (value == 0) {
+		*decpt = 1;
+		buf[0] = '0';
+		rve = buf + 1;
+	} else {
+		dsgn = digits32 (value, mode, ndigits, decpt, buf);
+		rve = buf + dsgn;
+	}
+#else
+#ifdef FAST_CVT
+	if (value != 0
+	    && (dsgn = fast_cvt (value, mode, ndigits, decpt, buf)) >= 0) {
+		digits = buf;
+		rve = buf + dsgn;
+	} else
+#endif
 	digits = _DTOA_R (data, value, mode, ndigits, decpt, &dsgn, &rve);
+#endif
+	*end = rve;
 
 	if ((ch != 'g' && ch != 'G') || flags & ALT) {	/* Print trailing zeros */
 		bp = digits + ndigits;
@@ -106,10 +431,8 @@ __cvt(struct _reent *data, _PRINTF_FLOAT_TYPE value, int ndigits, int flags,
 				*decpt = -ndigits + 1;
 			bp += *decpt;
 		}
-		if (value == 0)	/* kludge for __dtoa irregularity */
+		if (value == 0 || rve < bp)	/* kludge for __dtoa irregularity */
 			rve = bp;
-		while (rve < bp)
-			*rve++ = '0';
 	}
 	*length = rve - digits;
 	return (digits);
@@ -147,10 +470,10 @@ __exponent(char *p0, int exp, int fmtch)
 }
 /* Decode and print floating point number specified by "eEfgG". */
 int 
-_printf_float (struct _reent *data,
+_PRINTF_FLOAT (struct _reent *data,
 	       struct _prt_data_t *pdata,
 	       FILE *fp,
-	       int (*pfunc)(struct _reent *, int, FILE *),
+	       int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
 	       va_list *ap)
 {
 	char *decimal_point = _localeconv_r (data)->decimal_point;
@@ -161,6 +484,12 @@ _printf_float (struct _reent *data,
 	int expsize = 0;	/* character count for expstr */
 	int ndig = 0;		/* actual number of digits returned by cvt */
 	char *cp;
+	char *dend;		/* end of the digits stored by cvt */
+#ifdef FLOAT32
+	char cvtbuf[FLOAT32_DIG + 1];
+#else
+	char *cvtbuf = pdata->buf;
+#endif
 	int n;
 	int realsz;		/* field size expanded by dprec(not for _printf_float) */
 	char code = pdata->code;
@@ -170,6 +499,10 @@ _printf_float (struct _reent *data,
 	} else {
 		_fpvalue = GET_ARG (N, *ap, double);
 	}
+#ifdef FLOAT32
+	/* Only the precision of a float is kept.  */
+	_fpvalue = (float) _fpvalue;
+#endif
 
 	/* do this before tricky precision changes
 
@@ -207,7 +540,7 @@ _printf_float (struct _reent *data,
 	pdata->flags |= FPT;
 
 	cp = __cvt (data, _fpvalue, pdata->prec, pdata->flags, &softsign,
-		    &expt, code, &ndig, cp);
+		    &expt, code, &ndig, cvtbuf, &dend);
 
 	if (code == 'g' || code == 'G') {
 		if (expt <= -4 || expt > pdata->prec)
@@ -263,16 +596,15 @@ print_float:
 				if (expt || ndig || pdata->flags & ALT) {
 					PRINT (decimal_point, decp_len);
 					PAD (-expt, pdata->zero);
-					PRINT (cp, ndig);
+					PRINTANDPAD (cp, dend, ndig, pdata->zero);
 				}
 			} else {
-				char *convbuf = cp;
-				PRINTANDPAD(cp, convbuf + ndig,
+				PRINTANDPAD(cp, dend,
 					    pdata->lead, pdata->zero);
 				cp += pdata->lead;
 				if (expt < ndig || pdata->flags & ALT)
 				    PRINT (decimal_point, decp_len);
-				PRINTANDPAD (cp, convbuf + ndig,
+				PRINTANDPAD (cp, dend,
 					     ndig - expt, pdata->zero);
 			}
 		} else {	/* 'a', 'A', 'e', or 'E' */
@@ -281,7 +613,8 @@ print_float:
 				cp++;
 				PRINT (decimal_point, decp_len);
 				if (_fpvalue) {
-					PRINT (cp, ndig - 1);
+					PRINTANDPAD (cp, dend, ndig - 1,
+						     pdata->zero);
 				} else	/* 0.[0..] */
 					/* __dtoa irregularity */
 					PAD (ndig - 1, pdata->zero);
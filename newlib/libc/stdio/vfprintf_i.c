@@ -45,13 +45,43 @@
 
 #include "vfprintf_local.h"
 
+#if !defined(PREFER_SIZE_OVER_SPEED) && !defined(__OPTIMIZE_SIZE__)
+/* "00" to "99", for converting decimal numbers two digits at a time.  */
+static _CONST char digit_pairs[200] =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+#endif
+
+/* Print N > 0 copies of C, a buffer of them at a time.  */
+int
+_printf_pad (struct _reent *data,
+	     FILE *fp,
+	     int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	     int n,
+	     int c)
+{
+	char buf[PADSIZE];
+	int m;
+
+	memset (buf, c, n < PADSIZE ? n : PADSIZE);
+	for (; n > 0; n -= m) {
+		m = n < PADSIZE ? n : PADSIZE;
+		if (pfunc (data, fp, buf, m) == EOF)
+			return EOF;
+	}
+	return 0;
+}
+
 /* Decode and print non-floating point data. */
 int
 _printf_common (struct _reent *data,
 		struct _prt_data_t *pdata,
 		int *realsz,
 		FILE *fp,
-		int (*pfunc)(struct _reent *, int, FILE *))
+		int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t))
 {
 	int n;		/* handy integer (short term usage) */
 	/*
@@ -89,7 +119,8 @@ _printf_common (struct _reent *data,
 		pdata->l_buf[n++] = pdata->l_buf[2];
 	}
 
-	PRINT (pdata->l_buf, n);
+	if (n)
+		PRINT (pdata->l_buf, n);
 	n = pdata->width - *realsz;
 	if ((pdata->flags & (LADJUST|ZEROPAD)) != ZEROPAD || n < 0)
 		n = 0;
@@ -104,7 +135,8 @@ error:
 }
 int
 _printf_i (struct _reent *data, struct _prt_data_t *pdata, FILE *fp, 
-	   int (*pfunc)(struct _reent *, int, FILE *), va_list *ap)
+	   int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	   va_list *ap)
 {
 	int realsz;		/* field size expanded by dprec */
 	u_quad_t _uquad;
@@ -175,22 +207,52 @@ number:
 		 *	-- ANSI X3J11
 		 */
 		if (_uquad != 0 || pdata->prec != 0) {
+#if defined(PREFER_SIZE_OVER_SPEED) || defined(__OPTIMIZE_SIZE__)
 			do {
 				*--cp = xdigs[_uquad % base];
 				_uquad /= base;
 			} while (_uquad);
+#else
+			if (base == 10) {
+				/* Two digits per division by a constant, which
+				   the compiler turns into a multiplication.  */
+				while (_uquad >= 100) {
+					u_quad_t q = _uquad / 100;
+					n = (int) (_uquad - q * 100) * 2;
+					*--cp = digit_pairs[n + 1];
+					*--cp = digit_pairs[n];
+					_uquad = q;
+				}
+				if (_uquad >= 10) {
+					n = (int) _uquad * 2;
+					*--cp = digit_pairs[n + 1];
+					*--cp = digit_pairs[n];
+				} else
+					*--cp = '0' + (int) _uquad;
+			} else {
+				/* Base 8 or 16: shift and mask.  */
+				n = (base == 16) ? 4 : 3;
+				do {
+					*--cp = xdigs[_uquad & (base - 1)];
+					_uquad >>= n;
+				} while (_uquad);
+			}
+#endif
 		}
 		pdata->size = pdata->buf + BUF - cp;
 		/* For 'o' conversion, '#' increases the precision to force the first 
 		 * digit of the result to be zero.  */
-		if (base == 8 && (pdata->flags & ALT) && pdata->prec <= pdata->size)
-			pdata->prec = pdata->size + 1;
+		if (base == 8 && (pdata->flags & ALT) && pdata->dprec <= pdata->size
+		    && (pdata->size == 0 || *cp != '0'))
+			pdata->dprec = pdata->size + 1;
 		break;
 	case 'n':
 		if (pdata->flags & LONGINT)
 			*GET_ARG (N, *ap, long_ptr_t) = pdata->ret;
 		else if (pdata->flags & SHORTINT)
 			*GET_ARG (N, *ap, short_ptr_t) = pdata->ret;
+		else if (pdata->flags & CHARINT)
+			*GET_ARG (N, *ap, char_ptr_t) = pdata->ret;
 		else
 			*GET_ARG (N, *ap, int_ptr_t) = pdata->ret;
         case '\0':
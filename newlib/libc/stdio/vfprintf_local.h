@@ -115,6 +115,8 @@ extern char *_dtoa_r _PARAMS((struct _reent *, double, int,
    */
 #define	BUF		40
 
+#define	PADSIZE		16	/* pad chunk size */
+
 #define quad_t long
 #define u_quad_t unsigned long
 
@@ -148,9 +150,48 @@ typedef short *  short_ptr_t;
  * that %lld behaves the same as %ld, not as %d, as expected if:
  * sizeof (long long) = sizeof long > sizeof int  */
 #define QUADINT		LONGINT
-#define FPT		0x400		/* Floating point number */
-/* define as 0, to make SARG and UARG occupy fewer instructions  */
-# define CHARINT	0
+/* The C99 length modifiers.  z, j and t follow L in the format parser.
+ * The conversions using them are left to _printf_c99, so that the 64 bit
+ * arithmetic is only linked in when it is asked for.  */
+#define SIZEINT		0x200		/* z: size_t */
+#define MAXINT		0x400		/* j: intmax_t */
+#define PTRINT		0x800		/* t: ptrdiff_t */
+#define HHINT		0x1000		/* hh: char */
+#define LLINT		0x2000		/* ll: long long */
+#define C99INT		(LLINT | SIZEINT | MAXINT | PTRINT)
+#define FPT		0x4000		/* Floating point number */
+/* hh is printed by _printf_i.  */
+# define CHARINT	HHINT
+
+/* The flags the format parsers set for z, j, t and ll.  A type of the
+ * same size as long or int is printed by _printf_i as if l or no length
+ * modifier had been given.  Only wider types need _printf_c99.  */
+#if defined (__SIZE_MAX__) && __SIZE_MAX__ == __LONG_MAX__ * 2UL + 1
+# define SIZEINT_FLAGS	LONGINT
+#elif defined (__SIZE_MAX__) && __SIZE_MAX__ == __INT_MAX__ * 2U + 1
+# define SIZEINT_FLAGS	0
+#else
+# define SIZEINT_FLAGS	SIZEINT
+#endif
+#if defined (__INTMAX_MAX__) && __INTMAX_MAX__ == __LONG_MAX__
+# define MAXINT_FLAGS	LONGINT
+#elif defined (__INTMAX_MAX__) && __INTMAX_MAX__ == __INT_MAX__
+# define MAXINT_FLAGS	0
+#else
+# define MAXINT_FLAGS	MAXINT
+#endif
+#if defined (__PTRDIFF_MAX__) && __PTRDIFF_MAX__ == __LONG_MAX__
+# define PTRINT_FLAGS	LONGINT
+#elif defined (__PTRDIFF_MAX__) && __PTRDIFF_MAX__ == __INT_MAX__
+# define PTRINT_FLAGS	0
+#else
+# define PTRINT_FLAGS	PTRINT
+#endif
+#if __LONG_LONG_MAX__ == __LONG_MAX__
+# define LLINT_FLAGS	LONGINT
+#else
+# define LLINT_FLAGS	LLINT
+#endif
 
 /* Macros to support positional arguments */
 #define GET_ARG(n, ap, type) (va_arg ((ap), type))
@@ -162,42 +203,46 @@ typedef short *  short_ptr_t;
  */
 #define	SARG(flags) \
 	(flags&LONGINT ? GET_ARG (N, (*ap), long) : \
-	    flags&SHORTINT ? (long)(short)GET_ARG (N, (*ap), int) : \
-	    flags&CHARINT ? (long)(signed char)GET_ARG (N, (*ap), int) : \
-	    (long)GET_ARG (N, (*ap), int))
+	    _sarg_int (flags, GET_ARG (N, (*ap), int)))
 #define	UARG(flags) \
 	(flags&LONGINT ? GET_ARG (N, (*ap), u_long) : \
-	    flags&SHORTINT ? (u_long)(u_short)GET_ARG (N, (*ap), int) : \
-	    flags&CHARINT ? (u_long)(unsigned char)GET_ARG (N, (*ap), int) : \
-	    (u_long)GET_ARG (N, (*ap), u_int))
+	    _uarg_int (flags, GET_ARG (N, (*ap), u_int)))
+
+/* Narrow an int argument for h and hh.  The argument is fetched once
+ * for all three, which keeps _printf_i small.  */
+static __inline__ long
+_sarg_int (int flags, int arg)
+{
+	return flags&SHORTINT ? (short)arg :
+	    flags&CHARINT ? (signed char)arg : arg;
+}
+
+static __inline__ u_long
+_uarg_int (int flags, u_int arg)
+{
+	return flags&SHORTINT ? (u_short)arg :
+	    flags&CHARINT ? (unsigned char)arg : arg;
+}
 
 /*
  * BEWARE, these `goto error' on error. And they are used
  * in more than one functions.
  *
- * Following macros are each referred about twice in printf for integer,
- * so it is not worth to rewrite them into functions. This situation may
- * change in the future.
+ * PRINT hands a whole span to the output function, which copies it
+ * into the stream or string buffer in one go, and PAD does the same
+ * for padding through _printf_pad.
  */
 #define PRINT(ptr, len) {		\
-	int temp_i = 0;			\
-	while (temp_i < (len))		\
-	{				\
-		if (pfunc (data, (ptr)[temp_i], fp) == EOF) \
-			goto error;	\
-		temp_i++;		\
-	}				\
+	if (pfunc (data, fp, (ptr), (len)) == EOF) \
+		goto error;		\
 }
 
 #define PAD(howmany, ch) {		\
-	int temp_i = 0;			\
-	while (temp_i < (howmany))	\
-	{				\
-		if (pfunc (data, (ch), fp) == EOF) \
-			goto error;	\
-		temp_i++;		\
-	}				\
+	if ((howmany) > 0		\
+	    && _printf_pad (data, fp, pfunc, (howmany), (ch)) == EOF) \
+		goto error;		\
 }
+
 #define PRINTANDPAD(p, ep, len, ch) {	\
 	int temp_n = (ep) - (p);	\
 	if (temp_n > (len))		\
@@ -233,11 +278,19 @@ _printf_common (struct _reent *data,
 		struct _prt_data_t *pdata,
 		int *realsz,
 		FILE *fp,
-		int (*pfunc)(struct _reent *, int, FILE *));
+		int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t));
+
+extern int
+_printf_pad (struct _reent *data,
+	     FILE *fp,
+	     int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	     int n,
+	     int c);
 
 extern int
 _printf_i (struct _reent *data, struct _prt_data_t *pdata, FILE *fp, 
-	   int (*pfunc)(struct _reent *, int, FILE *), va_list *ap);
+	   int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	   va_list *ap);
 
 /* Make _printf_float weak symbol, so it won't be linked in if target program 
  * does not need it.  */
@@ -245,6 +298,68 @@ extern int
 _printf_float (struct _reent *data,
 	       struct _prt_data_t *pdata,
 	       FILE *fp,
-	       int (*pfunc)(struct _reent *, int, FILE *),
+	       int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
 	       va_list *ap) __attribute__ ((weak));
+
+/* Likewise for the float only variant of _printf_float, which takes
+   precedence when it is linked.  */
+extern int
+_printf_float32 (struct _reent *data,
+		 struct _prt_data_t *pdata,
+		 FILE *fp,
+		 int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+		 va_list *ap) __attribute__ ((weak));
+
+/* Likewise for the conversions with C99 length modifiers.  */
+extern int
+_printf_c99 (struct _reent *data,
+	     struct _prt_data_t *pdata,
+	     FILE *fp,
+	     int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	     va_list *ap) __attribute__ ((weak));
+
+/* The output functions of vfprintf, for files and for strings.  */
+extern int
+__sfputs_r (struct _reent *ptr, FILE *fp, _CONST char *buf, size_t len);
+
+extern int
+__ssputs_r (struct _reent *ptr, FILE *fp, _CONST char *buf, size_t len);
+
+/* Convert and print the argument of the conversion described by PDATA
+   with the function linked in for it, or consume the argument if there
+   is none.  Shared by _vfprintf_r and _vfprintf_pfmt_r.  */
+static __inline__ int
+_printf_conv (struct _reent *data,
+	      struct _prt_data_t *pdata,
+	      FILE *fp,
+	      int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t),
+	      va_list *ap)
+{
+#ifdef FLOATING_POINT
+	if (memchr ("efgEFG", pdata->code, 6)) {
+		/* Consume floating point argument if _printf_float is not linked.  */
+		if (_printf_float32 != NULL)
+			return _printf_float32 (data, pdata, fp, pfunc, ap);
+		if (_printf_float != NULL)
+			return _printf_float (data, pdata, fp, pfunc, ap);
+		if (pdata->flags & LONGDBL)
+			GET_ARG (N, *ap, _LONG_DOUBLE);
+		else
+			GET_ARG (N, *ap, double);
+		return 0;
+	}
+#endif
+	if (pdata->flags & C99INT) {
+		/* Consume the argument if _printf_c99 is not linked.
+		   Nothing is printed, so nothing is counted.  */
+		if (_printf_c99 != NULL)
+			return _printf_c99 (data, pdata, fp, pfunc, ap);
+		if ((pdata->flags & (LLINT | MAXINT)) && pdata->code != 'n')
+			GET_ARG (N, *ap, long long);
+		else
+			GET_ARG (N, *ap, long);
+		return 0;
+	}
+	return _printf_i (data, pdata, fp, pfunc, ap);
+}
 #endif
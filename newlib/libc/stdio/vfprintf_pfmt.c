@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2012 ARM Ltd
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. The name of the company may not be used to endorse or promote
+ *    products derived from this software without specific prior written
+ *    permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ARM LTD ``AS IS'' AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL ARM LTD BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* Print with a format compiled by pfmt_compile.  Built like vfprintf.c,
+   once for files and once with STRING_ONLY for strings.  */
+
+#include <newlib.h>
+
+#ifdef STRING_ONLY
+#  define _VFPRINTF_PFMT_R _svfprintf_pfmt_r
+#  define __SPRINT __ssputs_r
+#else
+#  define _VFPRINTF_PFMT_R _vfprintf_pfmt_r
+#  define __SPRINT __sfputs_r
+#endif
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <wchar.h>
+#include <sys/lock.h>
+#include <stdarg.h>
+#include "local.h"
+#include "../stdlib/local.h"
+#include "fvwrite.h"
+#include "vfieeefp.h"
+
+#include "vfprintf_local.h"
+
+int
+_DEFUN(_VFPRINTF_PFMT_R, (data, fp, pf, ap0),
+       struct _reent *data _AND
+       FILE * fp           _AND
+       _CONST pfmt_t *pf   _AND
+       va_list ap0)
+{
+	register int n;		/* handy integer (short term usage) */
+	struct _prt_data_t prt_data;	/* all data for decoding format string */
+	/* output function pointer */
+	int (*pfunc)(struct _reent *, FILE *, _CONST char *, size_t);
+	va_list ap;	/* argument list, passed on by address */
+
+	pfunc = __SPRINT;
+
+#ifndef STRING_ONLY
+	/* Initialize std streams if not dealing with sprintf family.  */
+	CHECK_INIT (data, fp);
+	_flockfile (fp);
+
+	if (cantwrite (data, fp)) {
+		_funlockfile (fp);
+		return (EOF);
+	}
+#else /* STRING_ONLY */
+	/* Create initial buffer if we are called by asprintf family.  */
+	if (fp->_flags & __SMBF && !fp->_bf._base) {
+		fp->_bf._base = fp->_p = _malloc_r (data, 64);
+		if (!fp->_p) {
+			data->_errno = ENOMEM;
+			return EOF;
+		}
+		fp->_bf._size = 64;
+	}
+#endif /* STRING_ONLY */
+
+	va_copy (ap, ap0);
+	prt_data.ret = 0;
+	prt_data.blank = ' ';
+	prt_data.zero = '0';
+
+	/* The parsing was done by pfmt_compile; print the literal text of
+	   each entry and convert its argument, as _VFPRINTF_R does.  */
+	for (;; pf++) {
+		if (pf->_litlen != 0) {
+			PRINT (pf->_lit, pf->_litlen);
+			prt_data.ret += pf->_litlen;
+		}
+		if (pf->_code == '\0')
+			break;
+
+		prt_data.flags = pf->_flags;
+		prt_data.width = pf->_width;
+		prt_data.prec = pf->_prec;
+		prt_data.dprec = 0;
+		prt_data.l_buf[0] = pf->_sign;
+#ifdef FLOATING_POINT
+		prt_data.lead = 0;
+#endif
+		if (prt_data.width < 0) {
+			prt_data.width = GET_ARG (n, ap, int);
+			if (prt_data.width < 0) {
+				prt_data.width = -prt_data.width;
+				prt_data.flags |= LADJUST;
+			}
+		}
+		if (prt_data.prec == -2) {
+			prt_data.prec = GET_ARG (n, ap, int);
+			if (prt_data.prec < 0)
+				prt_data.prec = -1;
+		}
+		prt_data.code = pf->_code;
+		n = _printf_conv (data, &prt_data, fp, pfunc, &ap);
+		if (n == -1)
+			goto error;
+		prt_data.ret += n;
+	}
+error:
+	va_end (ap);
+#ifndef STRING_ONLY
+	_funlockfile (fp);
+#endif
+	return (__sferror (fp) ? EOF : prt_data.ret);
+}
@@ -300,11 +300,11 @@ size_t _EXFUN (_sfread_r, (struct _reent *, _PTR buf, size_t, size_t, FILE *));
 #endif /* !STRING_ONLY */
 
 int
-_DEFUN(__SVFSCANF_R, (rptr, fp, fmt0, ap),
+_DEFUN(__SVFSCANF_R, (rptr, fp, fmt0, ap0),
        struct _reent *rptr _AND
        register FILE *fp   _AND
        char _CONST *fmt0   _AND
-       va_list ap)
+       va_list ap0)
 {
 	register u_char *fmt = (u_char *) fmt0;
 	register int c;		/* character from format, or conversion */
@@ -316,10 +316,15 @@ _DEFUN(__SVFSCANF_R, (rptr, fp, fmt0, ap),
 
 	struct _scan_data_t scan_data;
 	int (*scan_func)(struct _reent*, struct _scan_data_t*, FILE *, va_list *);
+	va_list ap;	/* argument list, passed on by address */
 
 	__sfp_lock_acquire ();
 	_flockfile (fp);
 
+	/* As in _VFPRINTF_R, pass the address of a local copy of the
+	   argument list, not of the parameter.  */
+	va_copy (ap, ap0);
+
 	scan_data.nassigned = 0;
 	scan_data.nread = 0;
 	scan_data.ccltab = ccltab;
@@ -427,6 +432,7 @@ number:
 		 * Disgusting backwards compatibility hacks.	XXX
 		 */
 		case '\0':		/* compat */
+			va_end (ap);
 			_funlockfile (fp);
 			__sfp_lock_release ();
 			return EOF;
@@ -474,6 +480,8 @@ number:
 		else if (scan_data.code < CT_FLOAT)
 			ret = _scanf_i (rptr, &scan_data, fp, &ap);
 #ifdef FLOATING_POINT
+		else if (_scanf_float32)
+			ret = _scanf_float32 (rptr, &scan_data, fp, &ap);
 		else if (_scanf_float)
 			ret = _scanf_float (rptr, &scan_data, fp, &ap);
 #endif
@@ -488,12 +496,14 @@ input_failure:
 	   should have been set prior to here.  On EOF failure (including
 	   invalid format string), return EOF if no matches yet, else number
 	   of matches made prior to failure.  */
+	va_end (ap);
 	_funlockfile (fp);
 	__sfp_lock_release ();
 	return scan_data.nassigned && !(fp->_flags & __SERR) ? scan_data.nassigned : EOF;
 match_failure:
 all_done:
 	/* Return number of matches, which can be 0 on match failure.  */
+	va_end (ap);
 	_funlockfile (fp);
 	__sfp_lock_release ();
 	return scan_data.nassigned;
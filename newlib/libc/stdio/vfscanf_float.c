@@ -34,8 +34,201 @@
 #include "vfscanf_local.h"
 
 #ifdef FLOATING_POINT
+
+#ifdef FLOAT32
+#include "vfloat32.h"
+# define _SCANF_FLOAT	_scanf_float32
+
+/* Most significant digits looked at.  A float halfway between two
+   others has fewer, so any further digits only tell whether the number
+   is above such a point.  */
+#define STRTOF32_DIG	(FLOAT32_DIG + 8)
+/* Words for the digits shifted left so that dividing by the power of
+   ten still leaves 66 bits.  */
+#define STRTOF32_WORDS	21
+
+/* Return the number of significant bits of X, which has N words.  */
+static int
+bitlen32 (__uint32_t *x, int n)
+{
+	__uint32_t w;
+	int b;
+
+	if (n == 0)
+		return 0;
+	for (b = 32 * (n - 1), w = x[n - 1]; w != 0; w >>= 1)
+		b++;
+	return b;
+}
+
+/* Return the float nearest to the number S, as collected by
+   _scanf_float32, rounding ties to even like _strtod_r does.  */
+static float
+strtof32 (struct _reent *rptr, const char *s)
+{
+	union { float f; __uint32_t i; } u;
+	__uint32_t x[STRTOF32_WORDS], acc, pow, r;
+	uint64_t q, half;
+	int n, nd, dot, exp, e10, e2, neg, sticky, s2, b, i, keep, drop;
+
+	u.i = 0;
+	if (*s == '-')
+		u.i = 0x80000000;
+	if (*s == '-' || *s == '+')
+		s++;
+	if (*s == 'i' || *s == 'I') {
+		u.i |= 0x7f800000;
+		return u.f;
+	}
+	if (*s == 'n' || *s == 'N') {
+		u.i = 0x7fc00000;
+		return u.f;
+	}
+
+	/* Collect the digits in X, nine at a time, and the power of ten
+	   to scale them by in EXP.  */
+	n = nd = dot = exp = sticky = 0;
+	acc = 0;
+	pow = 1;
+	for (;; s++) {
+		if (*s == '.') {
+			dot = 1;
+			continue;
+		}
+		if (*s < '0' || *s > '9')
+			break;
+		if (nd == 0 && *s == '0') {
+			exp -= dot;
+			continue;
+		}
+		if (nd == STRTOF32_DIG) {
+			sticky |= *s != '0';
+			exp += !dot;
+			continue;
+		}
+		acc = acc * 10 + (*s - '0');
+		pow *= 10;
+		nd++;
+		exp -= dot;
+		if (pow == 1000000000 || nd == STRTOF32_DIG) {
+			if ((r = f32_muladd (x, n, pow, acc)) != 0)
+				x[n++] = r;
+			acc = 0;
+			pow = 1;
+		}
+	}
+	if (pow > 1 && (r = f32_muladd (x, n, pow, acc)) != 0)
+		x[n++] = r;
+	if (*s == 'e' || *s == 'E') {
+		neg = *++s == '-';
+		if (*s == '-' || *s == '+')
+			s++;
+		for (e10 = 0; *s >= '0' && *s <= '9'; s++)
+			if (e10 < 100000)
+				e10 = e10 * 10 + (*s - '0');
+		exp += neg ? -e10 : e10;
+	}
+
+	/* The number is below 10^(ND + EXP).  */
+	if (n == 0)
+		return u.f;
+	if (nd + exp > 39)
+		goto overflow;
+	if (nd + exp < -45)
+		goto underflow;
+
+	/* Scale X, so that the number is X * 2^-S2 and a bit more if
+	   STICKY is set.  */
+	s2 = 0;
+	if (exp >= 0) {
+		for (; exp > 0; exp -= 9) {
+			for (pow = 1, i = 0; i < exp && i < 9; i++)
+				pow *= 10;
+			if ((r = f32_muladd (x, n, pow, 0)) != 0)
+				x[n++] = r;
+		}
+	} else {
+		/* 1701 / 512 is slightly above log2 (10).  */
+		s2 = 67 + ((-exp * 1701) >> 9) - bitlen32 (x, n);
+		if (s2 > 0) {
+			i = s2 >> 5;
+			memmove (x + i, x, n * sizeof (x[0]));
+			memset (x, 0, i * sizeof (x[0]));
+			n += i;
+			if ((r = f32_muladd (x + i, n - i, (__uint32_t) 1 << (s2 & 31),
+						0)) != 0)
+				x[n++] = r;
+		} else
+			s2 = 0;
+		for (; exp < 0; exp += 4) {
+			for (pow = 1, i = 0; i < -exp && i < 4; i++)
+				pow *= 10;
+			sticky |= f32_div (x, n, pow) != 0;
+			n = f32_trim (x, n);
+		}
+	}
+
+	/* Keep the top 64 bits in Q.  */
+	b = bitlen32 (x, n);
+	if (b > 64) {
+		drop = b - 64;
+		i = drop >> 5;
+		drop &= 31;
+		q = ((uint64_t) x[i + 1] << 32 | x[i]) >> drop;
+		if (drop != 0 && i + 2 < n)
+			q |= (uint64_t) x[i + 2] << (64 - drop);
+		sticky |= (x[i] & (((__uint32_t) 1 << drop) - 1)) != 0;
+		while (--i >= 0)
+			sticky |= x[i] != 0;
+		s2 -= b - 64;
+		b = 64;
+	} else
+		q = n > 1 ? (uint64_t) x[1] << 32 | x[0] : x[0];
+
+	/* Round to the 24 bits of a normal float, or to a multiple of
+	   2^-149 for a subnormal one.  */
+	e2 = b - 1 - s2;		/* the exponent of the top bit */
+	keep = e2 < -126 ? e2 + 150 : 24;
+	if (keep < 0)
+		goto underflow;
+	drop = b - keep;
+	if (drop > 0) {
+		half = (uint64_t) 1 << (drop - 1);
+		r = drop < 64 ? (__uint32_t) (q >> drop) : 0;
+		q &= (half << 1) - 1;
+		if (q > half || (q == half && (sticky || (r & 1))))
+			r++;
+	} else
+		r = (__uint32_t) q << -drop;
+	if (keep < 24) {
+		if (r == 0)
+			goto underflow;
+		u.i |= r;
+		return u.f;
+	}
+	if (r >> 24) {
+		r >>= 1;
+		e2++;
+	}
+	if (e2 > 127)
+		goto overflow;
+	u.i |= (__uint32_t) (e2 + 127) << 23 | (r & 0x7fffff);
+	return u.f;
+
+overflow:
+	rptr->_errno = ERANGE;
+	u.i |= 0x7f800000;
+	return u.f;
+underflow:
+	rptr->_errno = ERANGE;
+	return u.f;
+}
+#else
+# define _SCANF_FLOAT	_scanf_float
+#endif /* FLOAT32 */
+
 int
-_scanf_float (struct _reent *rptr, struct _scan_data_t *pdata, FILE *fp, va_list *ap)
+_SCANF_FLOAT (struct _reent *rptr, struct _scan_data_t *pdata, FILE *fp, va_list *ap)
 {
 	int c;
 	char *p;
@@ -286,7 +479,11 @@ fskip:
 		/* Current _strtold routine is markedly slower than
 		   _strtod_r.  Only use it if we have a long double
 		   result.  */
+#ifdef FLOAT32
+		fp = strtof32 (rptr, pdata->buf);
+#else
 		fp = _strtod_r (rptr, pdata->buf, NULL);
+#endif
 
 		/* Do not support long double */
 		if (pdata->flags & LONG)
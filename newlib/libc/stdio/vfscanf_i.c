@@ -44,29 +44,51 @@
 
 #include "vfscanf_local.h"
 
+/* Consume up to WIDTH characters from the read window of FP, which is
+   refilled as it runs out.  */
 int
 _scanf_chars (struct _reent *rptr, struct _scan_data_t *pdata, FILE *fp, va_list *ap)
 {
-	int n;
+	unsigned char *s;
 	char *p;
+	size_t k, lim;
+	int n;
 
 	if (pdata->width == 0)
 		pdata->width = (pdata->code == CT_CHAR) ? 1 : (size_t)~0;
 
 	n = 0;
+	p = NULL;
 	if ((pdata->flags & SUPPRESS) == 0)
 		p = GET_ARG (N, *ap, char *);
-	/* It's impossible to have EOF when we get here. */
-	while ((pdata->code == CT_CHAR)
-	       || (pdata->code == CT_CCL && pdata->ccltab[*fp->_p])
-	       || (pdata->code == CT_STRING && !isspace (*fp->_p))) {
-		n++;
-		if ((pdata->flags & SUPPRESS) == 0)
-			*p++ = *fp->_p;
-		fp->_r--, fp->_p++;
-		if (--pdata->width == 0)
+	/* It's impossible to have EOF when we get here.  Scan what is
+	   left of the window in one go, without going back to FP for
+	   every character.  */
+	for (;;) {
+		s = fp->_p;
+		lim = fp->_r;
+		if (lim > pdata->width)
+			lim = pdata->width;
+		k = 0;
+		if (pdata->code == CT_CHAR)
+			k = lim;
+		else if (pdata->code == CT_CCL)
+			while (k < lim && pdata->ccltab[s[k]])
+				k++;
+		else
+			while (k < lim && !isspace (s[k]))
+				k++;
+		if (p != NULL) {
+			memcpy (p, s, k);
+			p += k;
+		}
+		fp->_p += k;
+		fp->_r -= k;
+		n += k;
+		pdata->width -= k;
+		if (k < lim || pdata->width == 0)
 			break;
-		if ((fp->_r <= 0 && pdata->pfn_refill (rptr, fp)))
+		if (pdata->pfn_refill (rptr, fp))
 			break;
 	}
 	/* for CT_CHAR, it is impossible to have input_failure(n == 0) here;
@@ -83,99 +105,102 @@ _scanf_chars (struct _reent *rptr, struct _scan_data_t *pdata, FILE *fp, va_list
 	pdata->nread += n;
 	return 0;
 }
+
+/* Scan an integer as if by strtol/strtoul, accumulating its value as
+   the digits are read instead of collecting them for strtol.  */
 int
 _scanf_i (struct _reent *rptr, struct _scan_data_t *pdata, FILE *fp, va_list *ap)
 {
-	#define CCFN_PARAMS	_PARAMS((struct _reent *, const char *, char **, int))
-	u_long (*ccfn)CCFN_PARAMS=0;	/* conversion function (strtol/strtoul) */
-	char *p;
-	int n;				/* handy integers (short term usage)  */
-	char *xdigits = "A-Fa-f8901234567]";
-	char *prefix_chars[3] = {"+-", "00", "xX"};
+	unsigned char *s;
+	size_t width, k, lim;
+	u_long acc, cutoff;
+	int n;				/* characters consumed */
+	int last;			/* last prefix character consumed */
+	int base, c, d, neg, any, cutlim;
 
-	/* scan an integer as if by strtol/strtoul */
-	unsigned width_left = 0;
-	int skips = 0;
+	width = pdata->width ? pdata->width : (size_t)~0;
+	base = pdata->base;
+	neg = 0;
+	last = 0;
+	n = 0;
+	acc = 0;
+	any = 0;
+	pdata->flags |= NDIGITS;
 
-	ccfn = (pdata->code == CT_INT) ? (u_long (*)CCFN_PARAMS)_strtol_r : _strtoul_r;
-#ifdef hardway
-	if (pdata->width == 0 || pdata->width > BUF - 1)
-#else
-	/* size_t is unsigned, hence this optimisation */
-	if (pdata->width - 1 > BUF - 2)
-#endif
-	{
-		width_left = pdata->width - (BUF - 1);
-		pdata->width = BUF - 1;
-	}
-	p = pdata->buf;
-	pdata->flags |= NDIGITS | NZDIGITS | NNZDIGITS;
+/* Consume the prefix character C, or go to match_end at EOF.  */
+#define TAKE(c) {					\
+	last = (c);					\
+	n++;						\
+	width--;					\
+	fp->_p++;					\
+	if (--fp->_r <= 0 && pdata->pfn_refill (rptr, fp))\
+		goto match_end;				\
+}
 
 	/* process [sign] [0] [xX] prefixes sequently */
-	for (n = 0; n < 3; n++) {
-		if (!memchr (prefix_chars[n], *fp->_p, 2))
-			continue;
-		if (n == 1) {
-			if (pdata->base == 0) {
-				pdata->base = 8;
-				pdata->flags |= PFXOK;
-			}
-			pdata->flags &= ~(NZDIGITS | NDIGITS);
+	c = *fp->_p;
+	if (c == '+' || c == '-') {
+		neg = (c == '-');
+		TAKE (c);
+	}
+	if (width > 0 && *fp->_p == '0') {
+		if (base == 0) {
+			base = 8;
+			pdata->flags |= PFXOK;
 		}
-		else if (n == 2) {
-			if ((pdata->flags & (PFXOK | NZDIGITS)) != PFXOK)
-				continue;
-			pdata->base = 16;
-                          
-			/* We must reset the NZDIGITS and NDIGITS
-			   flags that would have been unset by seeing
-			   the zero that preceded the X or x.  */
-			/* ??? It seems non-sense to reset the NZDIGITS. */
+		pdata->flags &= ~NDIGITS;
+		TAKE ('0');
+		c = *fp->_p;
+		if (width > 0 && (c == 'x' || c == 'X')
+		    && (pdata->flags & PFXOK)) {
+			base = 16;
 			pdata->flags |= NDIGITS;
-		}
-		if (pdata->width-- > 0) {
-			*p++ = *fp->_p++;
-			fp->_r--;
-			if ((fp->_r <= 0 && pdata->pfn_refill (rptr, fp)))
-				goto match_end;
+			TAKE (c);
 		}
 	}
-   
-	if (pdata->base == 0)
-		pdata->base = 10;
+	if (base == 0)
+		base = 10;
 
-	/* The check is un-necessary if xdigits points to exactly the string:
-	 * "A-Fa-f8901234567]" */
-#if 0
-	if (pdata->base != 16)
-#endif
-		xdigits = xdigits + 16 - pdata->base;
+	if (pdata->code == CT_INT)
+		cutoff = neg ? -(u_long) LONG_MIN : LONG_MAX;
+	else
+		cutoff = ULONG_MAX;
+	cutlim = cutoff % base;
+	cutoff /= base;
 
-	/* Initilize ccltab according to pdata->base.  */
-	__sccl (pdata->ccltab, (unsigned char *) xdigits);
-	for (; pdata->width; pdata->width--) {
-		n = *fp->_p;
-		if (pdata->ccltab[n] == 0)
-			break;
-		else if (n == '0' && (pdata->flags & NNZDIGITS)) {
-			++skips;
-			if (width_left) {
-				width_left--;
-				pdata->width++;
+	/* The digits, a window at a time.  */
+	while (width > 0) {
+		s = fp->_p;
+		lim = fp->_r;
+		if (lim > width)
+			lim = width;
+		for (k = 0; k < lim; k++) {
+			c = s[k];
+			d = to_digit (c);
+			if ((unsigned) d > 9) {
+				d = (c | 0x20) - 'a';
+				d = ((unsigned) d < 26) ? d + 10 : base;
 			}
-			goto skip;
+			if (d >= base)
+				break;
+			if (any < 0 || acc > cutoff
+			    || (acc == cutoff && d > cutlim))
+				any = -1;
+			else
+				acc = acc * base + d;
 		}
-		pdata->flags &= ~(NDIGITS | NNZDIGITS);
-		/*
-		 * char is legal: store it and look at the next.
-		 */
-		*p++ = *fp->_p;
-skip:
-		if (--fp->_r > 0)
-			fp->_p++;
-		else if (pdata->pfn_refill (rptr, fp))
+		if (k > 0)
+			pdata->flags &= ~NDIGITS;
+		fp->_p += k;
+		fp->_r -= k;
+		n += k;
+		width -= k;
+		if (k < lim || width == 0)
+			break;
+		if (pdata->pfn_refill (rptr, fp))
 			break;		/* EOF */
 	}
+
 	/*
 	 * If we had only a sign, it is no good; push back the sign.
 	 * If the number ends in `x', it was [sign] '0' 'x', so push back
@@ -186,26 +211,33 @@ skip:
 	 */
 match_end:
 	if (pdata->flags & NDIGITS) {
-		if (p > pdata->buf)
-			pdata->pfn_ungetc (rptr, *--p, fp); /* [-+xX] */
-		if (p == pdata->buf)
+		if (n > 0) {
+			pdata->pfn_ungetc (rptr, last, fp); /* [-+xX] */
+			n--;
+		}
+		if (n == 0)
 			return MATCH_FAILURE;
 	}
 	if ((pdata->flags & SUPPRESS) == 0) {
-		u_long ul;
-		*p = 0;
-		ul = (*ccfn) (rptr, pdata->buf, (char **) NULL, pdata->base);
+		if (any < 0) {
+			if (pdata->code == CT_INT)
+				acc = neg ? (u_long) LONG_MIN : LONG_MAX;
+			else
+				acc = ULONG_MAX;
+			rptr->_errno = ERANGE;
+		}
+		else if (neg)
+			acc = -acc;
 		if (pdata->flags & POINTER)
-			*GET_ARG (N, *ap, void **) = (void *) (uintptr_t) ul;
+			*GET_ARG (N, *ap, void **) = (void *) (uintptr_t) acc;
 		else if (pdata->flags & SHORT)
-			*GET_ARG (N, *ap, short *) = ul;
+			*GET_ARG (N, *ap, short *) = acc;
 		else if (pdata->flags & LONG)
-			*GET_ARG (N, *ap, long *) = ul;
+			*GET_ARG (N, *ap, long *) = acc;
 		else
-			*GET_ARG (N, *ap, int *) = ul;
+			*GET_ARG (N, *ap, int *) = acc;
 		pdata->nassigned++;
 	}
-	pdata->nread += p - pdata->buf + skips;
+	pdata->nread += n;
 	return 0;
 }
-
@@ -179,4 +179,12 @@ _scanf_float (struct _reent *rptr,
 	      FILE *fp,
 	      va_list *ap) __attribute__ ((weak));
 
+/* Likewise for the float only variant, which takes precedence when it
+   is linked.  */
+extern int
+_scanf_float32 (struct _reent *rptr,
+		struct _scan_data_t *pdata,
+		FILE *fp,
+		va_list *ap) __attribute__ ((weak));
+
 #endif
@@ -75,6 +75,7 @@ _DEFUN(__swsetup_r, (ptr, fp),
        */
       fp->_w = 0;
       fp->_lbfsize = -fp->_bf._size;
+      __slbf_add (ptr, fp);
     }
   else
     fp->_w = fp->_flags & __SNBF ? 0 : fp->_bf._size;
@@ -92,7 +92,7 @@ _DEFUN (_fopen64_r, (ptr, file, mode),
   if ((f = _open64_r (ptr, file, oflags, 0666)) < 0)
     {
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* release */
+      __sfp_free (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
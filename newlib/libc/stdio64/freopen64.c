@@ -204,7 +204,7 @@ _DEFUN (_freopen64_r, (ptr, file, mode, fp),
 
   if (f < 0)
     {				/* did not get it after all */
-      fp->_flags = 0;		/* set it free */
+      __sfp_free (fp);		/* set it free */
       ptr->_errno = e;		/* restore in case _close clobbered */
       _funlockfile(fp);
 #ifndef __SINGLE_THREAD__
@@ -33,6 +33,7 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
 #include <string.h>
 #include <errno.h>
 
@@ -54,10 +55,23 @@
 #define RARG struct _reent *reent_ptr,
 #define RONEARG struct _reent *reent_ptr
 #define RCALL reent_ptr,
+#define RONECALL reent_ptr
 
-/* Disable MALLOC_LOCK so far. So it won't be thread safe */
+/* The thread cache needs the lock to protect the shared heap */
+#if defined (_NANO_MALLOC_TCACHE) && !defined (_NANO_MALLOC_LOCK)
+#define _NANO_MALLOC_LOCK
+#endif
+
+#ifdef _NANO_MALLOC_LOCK
+void __malloc_lock(struct _reent *);
+void __malloc_unlock(struct _reent *);
+#define MALLOC_LOCK __malloc_lock(reent_ptr)
+#define MALLOC_UNLOCK __malloc_unlock(reent_ptr)
+#else
+/* Disable MALLOC_LOCK by default. So it won't be thread safe */
 #define MALLOC_LOCK /*__malloc_lock(reent_ptr) */
 #define MALLOC_UNLOCK /*__malloc_unlock(reent_ptr) */
+#endif
 
 #define RERRNO reent_ptr->_errno
 
@@ -73,12 +87,19 @@
 #define nano_malloc_stats	_malloc_stats_r
 #define nano_mallinfo		_mallinfo_r
 #define nano_mallopt		_mallopt_r
+#define nano_malloc_walk	_malloc_walk_r
+#define nano_malloc_trim	_malloc_trim_r
+#define nano_malloc_add_region	_malloc_add_region_r
+#define nano_malloc_region	_malloc_region_r
 
 #else /* ! INTERNAL_NEWLIB */
 
 #define RARG
 #define RONEARG
 #define RCALL
+#define RONECALL
+/* The thread cache is kept in struct _reent */
+#undef _NANO_MALLOC_TCACHE
 #define MALLOC_LOCK
 #define MALLOC_UNLOCK
 #define RERRNO errno
@@ -95,10 +116,27 @@
 #define nano_malloc_stats	malloc_stats
 #define nano_mallinfo		mallinfo
 #define nano_mallopt		mallopt
+#define nano_malloc_walk	malloc_walk
+#define nano_malloc_trim	malloc_trim
+#define nano_malloc_add_region	malloc_add_region
+#define nano_malloc_region	malloc_region
 #endif /* ! INTERNAL_NEWLIB */
 
 /* Define free_list as internal name to avoid conflict with user names */
 #define free_list __malloc_free_list
+#ifdef _NANO_MALLOC_BINS
+#define free_bins __malloc_free_bins
+#endif
+#define heap_regions __malloc_heap_regions
+#define heap_nregions __malloc_heap_nregions
+#define heap_arena __malloc_heap_arena
+#define sbrk_top __malloc_sbrk_top
+#define sbrk_aligned __malloc_sbrk_aligned
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+#define heap_fresh __malloc_heap_fresh
+#endif
+#define trim_threshold __malloc_trim_threshold
+#define top_pad __malloc_top_pad
 
 #define ALIGN_TO(size, align) \
     (((size) + (align) -1) & ~((align) -1))
@@ -139,12 +177,66 @@ typedef struct malloc_chunk {
     struct malloc_chunk * next;
 }chunk;
 
-#define CHUNK_OFFSET ((malloc_size_t)(&(((struct malloc_chunk *)0)->next)))
+#define CHUNK_OFFSET ((malloc_size_t)offsetof(struct malloc_chunk, next))
 
 /* size of smallest possible chunk. A memory piece smaller than this size
  * won't be able to create a chunk */
 #define MALLOC_MINCHUNK (CHUNK_OFFSET + MALLOC_PADDING + MALLOC_MINSIZE)
 
+/* Chunk size is always a multiple of CHUNK_ALIGN, so small chunks can be
+ * kept in lists holding chunks of exactly one size */
+#define SIZE_CLASS(size) (((size) - MALLOC_MINCHUNK) / CHUNK_ALIGN)
+
+#ifdef _NANO_MALLOC_BINS
+/* Free chunks no bigger than MALLOC_BIN_MAXCHUNK are not inserted into the
+ * address sorted free_list.  They are kept in LIFO lists, one per chunk
+ * size, so that small blocks are allocated and freed in constant time.  */
+#ifndef MALLOC_BIN_MAXCHUNK
+#define MALLOC_BIN_MAXCHUNK (128U)
+#endif
+#define MALLOC_NBINS (SIZE_CLASS(MALLOC_BIN_MAXCHUNK) + 1)
+#endif /* _NANO_MALLOC_BINS */
+
+#ifdef _NANO_MALLOC_TCACHE
+/* Each thread keeps up to MALLOC_TCACHE_COUNT recently freed chunks of
+ * each size up to MALLOC_TCACHE_MAXCHUNK, hanging off its struct _reent.
+ * malloc and free use them without taking the malloc lock.  Cached chunks
+ * are still in use as far as the heap is concerned.  The cache is
+ * allocated on the first free of a small chunk, and returned to the heap
+ * by _reclaim_reent.  */
+#ifndef MALLOC_TCACHE_MAXCHUNK
+#define MALLOC_TCACHE_MAXCHUNK (64U)
+#endif
+#ifndef MALLOC_TCACHE_COUNT
+#define MALLOC_TCACHE_COUNT 8
+#endif
+#define MALLOC_TCACHE_NCLASSES (SIZE_CLASS(MALLOC_TCACHE_MAXCHUNK) + 1)
+
+struct __malloc_tcache {
+    chunk * list[MALLOC_TCACHE_NCLASSES];
+    unsigned char count[MALLOC_TCACHE_NCLASSES];
+};
+#endif /* _NANO_MALLOC_TCACHE */
+
+/* Memory obtained from sbrk is recorded as a list of regions, each of
+ * which is completely covered by adjacent chunks.  Normally sbrk returns
+ * contiguous memory and there is just one region.  A new region is only
+ * started when something else moved the break between two calls.  Once
+ * the table is full, further discontiguous memory is still used but can
+ * not be walked by malloc_walk.
+ * Memory given to malloc_add_region gets a region of its own.  The index
+ * of a region in the table identifies it for malloc_region, so entries
+ * are never moved or removed; a region trimmed down to nothing is kept
+ * with start == end and may be reused for sbrk memory.  */
+#ifndef MALLOC_MAX_REGIONS
+#define MALLOC_MAX_REGIONS 8
+#endif
+
+typedef struct malloc_region {
+    char * start;
+    char * end;
+}region;
+
 static chunk * get_chunk_from_ptr(void * ptr)
 {
     chunk * c = (chunk *)((char *)ptr - CHUNK_OFFSET);
@@ -156,13 +248,72 @@ static chunk * get_chunk_from_ptr(void * ptr)
 #ifdef DEFINE_MALLOC
 chunk * free_list = NULL;
 
+region heap_regions[MALLOC_MAX_REGIONS];
+int heap_nregions = 0;
+/* Total size obtained from sbrk, and end of the last piece obtained */
+malloc_size_t heap_arena = 0;
+char * sbrk_top = NULL;
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+/* Memory from here on has never been used since it came from sbrk */
+char * heap_fresh = NULL;
+#endif
+
+#ifdef _NANO_MALLOC_BINS
+chunk * free_bins[MALLOC_NBINS];
+
+int __malloc_consolidate(RONEARG);
+#endif
+
+#ifdef _NANO_MALLOC_TCACHE
+int __malloc_tcache_flush(RONEARG);
+#endif
+
+/** Function add_region
+  * Record memory newly obtained from sbrk, either by extending the region
+  * it is adjacent to or by starting a new one.
+  */
+static void add_region(char * p, malloc_size_t s)
+{
+    int i, empty = -1;
+
+    heap_arena += s;
+
+    for (i = 0; i < heap_nregions; i++)
+    {
+        if (heap_regions[i].end == p && p == sbrk_top)
+        {
+            heap_regions[i].end = p + s;
+            break;
+        }
+        if (heap_regions[i].start == heap_regions[i].end && empty < 0)
+            empty = i;
+    }
+
+    if (i == heap_nregions)
+    {
+        if (empty < 0 && heap_nregions < MALLOC_MAX_REGIONS)
+            empty = heap_nregions++;
+        if (empty >= 0)
+        {
+            heap_regions[empty].start = p;
+            heap_regions[empty].end = p + s;
+        }
+    }
+
+    sbrk_top = p + s;
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+    if (sbrk_top > heap_fresh)
+        heap_fresh = sbrk_top;
+#endif
+}
+
 /** Function sbrk_aligned
   * Algorithm:
   *   Use sbrk() to obtain more memory and ensure it is CHUNK_ALIGN aligned
   *   Optimise for the case that it is already aligned - only ask for extra
   *   padding after we know we need it
   */
-static void* sbrk_aligned(RARG malloc_size_t s)
+void* sbrk_aligned(RARG malloc_size_t s)
 {
     char *p, *align_p;
 
@@ -181,6 +332,7 @@ static void* sbrk_aligned(RARG malloc_size_t s)
         if (p == (void *)-1)
             return p;
     }
+    add_region(align_p, s);
     return align_p;
 }
 
@@ -188,6 +340,11 @@ static void* sbrk_aligned(RARG malloc_size_t s)
   * Algorithm:
   *   Walk through the free list to find the first match. If fails to find
   *   one, call sbrk to allocate a new chunk.
+  *   With _NANO_MALLOC_BINS, small requests are first served from the bin
+  *   of the exact chunk size.  Before calling sbrk, binned chunks are
+  *   merged back into the free list and the walk is retried.
+  *   With _NANO_MALLOC_TCACHE, small requests are first served from the
+  *   cache of the calling thread without taking the lock.
   */
 void * nano_malloc(RARG malloc_size_t s)
 {
@@ -208,8 +365,38 @@ void * nano_malloc(RARG malloc_size_t s)
         return NULL;
     }
 
+#ifdef _NANO_MALLOC_TCACHE
+    if (alloc_size <= MALLOC_TCACHE_MAXCHUNK
+        && reent_ptr->_malloc_tcache != NULL)
+    {
+        struct __malloc_tcache * tc = reent_ptr->_malloc_tcache;
+
+        r = tc->list[SIZE_CLASS(alloc_size)];
+        if (r != NULL)
+        {
+            tc->list[SIZE_CLASS(alloc_size)] = r->next;
+            tc->count[SIZE_CLASS(alloc_size)]--;
+            goto cached;
+        }
+    }
+#endif
+
     MALLOC_LOCK;
 
+#ifdef _NANO_MALLOC_BINS
+    if (alloc_size <= MALLOC_BIN_MAXCHUNK)
+    {
+        r = free_bins[SIZE_CLASS(alloc_size)];
+        if (r != NULL)
+        {
+            free_bins[SIZE_CLASS(alloc_size)] = r->next;
+            goto found;
+        }
+    }
+#endif
+#if defined (_NANO_MALLOC_BINS) || defined (_NANO_MALLOC_TCACHE)
+retry:
+#endif
     p = free_list;
     r = p;
 
@@ -244,6 +431,14 @@ void * nano_malloc(RARG malloc_size_t s)
     /* Failed to find a appropriate chunk. Ask for more memory */
     if (r == NULL) 
     {
+#ifdef _NANO_MALLOC_TCACHE
+        if (__malloc_tcache_flush(RONECALL))
+            goto retry;
+#endif
+#ifdef _NANO_MALLOC_BINS
+        if (__malloc_consolidate(RONECALL))
+            goto retry;
+#endif
         r = sbrk_aligned(RCALL alloc_size);
 
         /* sbrk returns -1 if fail to allocate */
@@ -255,7 +450,13 @@ void * nano_malloc(RARG malloc_size_t s)
         }
         r->size = alloc_size;
     }
+#ifdef _NANO_MALLOC_BINS
+found:
+#endif
     MALLOC_UNLOCK;
+#ifdef _NANO_MALLOC_TCACHE
+cached:
+#endif
 
     ptr = (char *)r + CHUNK_OFFSET;
 
@@ -276,31 +477,36 @@ void * nano_malloc(RARG malloc_size_t s)
 #define MALLOC_CHECK_DOUBLE_FREE
 
 extern chunk * free_list;
-/** Function nano_free
-  * Implementation of libc free.
-  * Algorithm:
-  *  Maintain a global free chunk single link list, headed by global 
-  *  variable free_list.
-  *  When free, insert the to-be-freed chunk into free list. The place to
-  *  insert should make sure all chunks are sorted by address from low to
-  *  high.  Then merge with neighbor chunks if adjacent.
+#ifdef _NANO_MALLOC_BINS
+extern chunk * free_bins[];
+#endif
+#ifdef _NANO_MALLOC_TCACHE
+void * nano_malloc(RARG malloc_size_t s);
+#endif
+extern region heap_regions[];
+extern int heap_nregions;
+extern malloc_size_t heap_arena;
+extern char * sbrk_top;
+
+/* Set by mallopt.  Free trims the heap when the top free chunk reaches
+ * trim_threshold bytes, leaving top_pad bytes.  0 disables it. */
+malloc_size_t trim_threshold = 0;
+malloc_size_t top_pad = 0;
+
+/** Function insert_chunk
+  * Insert a chunk into the free list, keeping all chunks sorted by
+  * address from low to high, and merge it with neighbor chunks if
+  * adjacent.  Must be called with the malloc lock held.
   */
-void nano_free (RARG void * free_p)
+static void insert_chunk(RARG chunk * p_to_free)
 {
-    chunk * p_to_free;
     chunk * p, * q;
 
-    if (free_p == NULL) return;
-
-    p_to_free = get_chunk_from_ptr(free_p);
-
-    MALLOC_LOCK;
     if (free_list == NULL)
     {
         /* Set first free list element */
         p_to_free->next = free_list;
         free_list = p_to_free;
-        MALLOC_UNLOCK;
         return;
     }
 
@@ -319,7 +525,6 @@ void nano_free (RARG void * free_p)
             p_to_free->next = free_list;
         }
         free_list = p_to_free;
-        MALLOC_UNLOCK;
         return;
     }
 
@@ -352,7 +557,6 @@ void nano_free (RARG void * free_p)
     {
         /* Report double free fault */
         RERRNO = ENOMEM;
-        MALLOC_UNLOCK;
         return;
     }
 #endif
@@ -370,8 +574,215 @@ void nano_free (RARG void * free_p)
         p_to_free->next = q;
         p->next = p_to_free;
     }
+}
+
+/** Function __malloc_trim_top
+  * Give the top free chunk back to the system with a negative sbrk if it
+  * borders the break and has at least threshold bytes, keeping pad bytes.
+  * Must be called with the malloc lock held.
+  * Return: 1 if memory was released, 0 otherwise.
+  */
+int __malloc_trim_top(RARG malloc_size_t pad, malloc_size_t threshold)
+{
+    chunk * p, * c;
+    malloc_size_t release;
+    int i;
+
+    if (free_list == NULL)
+        return 0;
+
+    /* The free list is sorted, so the top chunk is the last one */
+    p = NULL;
+    for (c = free_list; c->next != NULL; c = c->next)
+        p = c;
+
+    if ((char *)c + c->size != sbrk_top
+        || (malloc_size_t)c->size < threshold)
+        return 0;
+
+    pad = ALIGN_TO(pad, CHUNK_ALIGN);
+    if (pad != 0)
+        pad = max(pad, MALLOC_MINCHUNK);
+    if ((malloc_size_t)c->size <= pad)
+        return 0;
+    release = c->size - pad;
+
+    /* Somebody else moved the break, we can not give it back */
+    if (_sbrk_r(RCALL 0) != sbrk_top)
+        return 0;
+    if (_sbrk_r(RCALL -(ptrdiff_t)release) == (void *)-1)
+        return 0;
+
+    for (i = 0; i < heap_nregions; i++)
+    {
+        if (heap_regions[i].end == sbrk_top)
+        {
+            heap_regions[i].end -= release;
+            break;
+        }
+    }
+    heap_arena -= release;
+    sbrk_top -= release;
+
+    if (pad == 0)
+    {
+        if (p == NULL) free_list = NULL;
+        else p->next = NULL;
+    }
+    else
+        c->size = pad;
+    return 1;
+}
+
+/** Function free_chunk
+  * Return a chunk to the heap.  Must be called with the malloc lock held.
+  */
+static void free_chunk(RARG chunk * p_to_free)
+{
+#ifdef _NANO_MALLOC_BINS
+    if ((malloc_size_t)p_to_free->size <= MALLOC_BIN_MAXCHUNK)
+    {
+        chunk ** bin = &free_bins[SIZE_CLASS(p_to_free->size)];
+
+        p_to_free->next = *bin;
+        *bin = p_to_free;
+        return;
+    }
+#endif
+    insert_chunk(RCALL p_to_free);
+}
+
+#ifdef _NANO_MALLOC_TCACHE
+/** Function tcache_put
+  * Put a small chunk into the cache of the calling thread, creating the
+  * cache if needed.
+  * Return: non-zero if the chunk was cached.
+  */
+static int tcache_put(RARG chunk * p_to_free)
+{
+    struct __malloc_tcache * tc = reent_ptr->_malloc_tcache;
+    int i = SIZE_CLASS(p_to_free->size);
+
+    if (tc == NULL)
+    {
+        tc = nano_malloc(RCALL sizeof(struct __malloc_tcache));
+        if (tc == NULL)
+            return 0;
+        memset(tc, 0, sizeof(struct __malloc_tcache));
+        reent_ptr->_malloc_tcache = tc;
+    }
+
+    if (tc->count[i] >= MALLOC_TCACHE_COUNT)
+        return 0;
+
+    p_to_free->next = tc->list[i];
+    tc->list[i] = p_to_free;
+    tc->count[i]++;
+    return 1;
+}
+#endif /* _NANO_MALLOC_TCACHE */
+
+/** Function nano_free
+  * Implementation of libc free.
+  * Algorithm:
+  *  Maintain a global free chunk single link list, headed by global 
+  *  variable free_list.
+  *  When free, insert the to-be-freed chunk into free list. The place to
+  *  insert should make sure all chunks are sorted by address from low to
+  *  high.  Then merge with neighbor chunks if adjacent.
+  *  With _NANO_MALLOC_BINS, small chunks are pushed onto the bin of their
+  *  size instead and only merged when malloc runs out of free memory.
+  *  With _NANO_MALLOC_TCACHE, small chunks are first kept in the cache of
+  *  the calling thread without taking the lock.
+  */
+void nano_free (RARG void * free_p)
+{
+    chunk * p_to_free;
+
+    if (free_p == NULL) return;
+
+    p_to_free = get_chunk_from_ptr(free_p);
+
+#ifdef _NANO_MALLOC_TCACHE
+    if ((malloc_size_t)p_to_free->size <= MALLOC_TCACHE_MAXCHUNK
+        && tcache_put(RCALL p_to_free))
+        return;
+#endif
+
+    MALLOC_LOCK;
+    free_chunk(RCALL p_to_free);
+    if (trim_threshold != 0)
+        __malloc_trim_top(RCALL top_pad, trim_threshold);
     MALLOC_UNLOCK;
 }
+
+#ifdef _NANO_MALLOC_BINS
+/** Function __malloc_consolidate
+  * Move all chunks held in the size-class bins back into the free list,
+  * merging them with adjacent free chunks.  Called by malloc with the lock
+  * held when no chunk in the free list is big enough.
+  * Return: non-zero if any chunk was moved.
+  */
+int __malloc_consolidate(RONEARG)
+{
+    chunk * c;
+    int i, moved = 0;
+
+    for (i = 0; i < MALLOC_NBINS; i++)
+    {
+        while ((c = free_bins[i]) != NULL)
+        {
+            free_bins[i] = c->next;
+            insert_chunk(RCALL c);
+            moved = 1;
+        }
+    }
+    return moved;
+}
+#endif /* _NANO_MALLOC_BINS */
+
+#ifdef _NANO_MALLOC_TCACHE
+/** Function __malloc_tcache_flush
+  * Return all chunks cached by the thread of reent_ptr to the heap.
+  * Called with the malloc lock held.
+  * Return: non-zero if any chunk was returned.
+  */
+int __malloc_tcache_flush(RONEARG)
+{
+    struct __malloc_tcache * tc = reent_ptr->_malloc_tcache;
+    chunk * c;
+    int i, moved = 0;
+
+    if (tc == NULL)
+        return 0;
+
+    for (i = 0; i < MALLOC_TCACHE_NCLASSES; i++)
+    {
+        while ((c = tc->list[i]) != NULL)
+        {
+            tc->list[i] = c->next;
+            free_chunk(RCALL c);
+            moved = 1;
+        }
+        tc->count[i] = 0;
+    }
+    return moved;
+}
+
+/** Function __malloc_tcache_release
+  * Flush and free the cache of a thread that is going away.
+  */
+void __malloc_tcache_release(RONEARG)
+{
+    struct __malloc_tcache * tc = reent_ptr->_malloc_tcache;
+
+    MALLOC_LOCK;
+    __malloc_tcache_flush(RONECALL);
+    reent_ptr->_malloc_tcache = NULL;
+    free_chunk(RCALL get_chunk_from_ptr(tc));
+    MALLOC_UNLOCK;
+}
+#endif /* _NANO_MALLOC_TCACHE */
 #endif /* DEFINE_FREE */
 
 #ifdef DEFINE_CFREE
@@ -385,13 +796,46 @@ void nano_cfree(RARG void * ptr)
 
 #ifdef DEFINE_CALLOC
 void * nano_malloc(RARG malloc_size_t s);
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+extern char * heap_fresh;
+#endif
 
 /* Function nano_calloc
- * Implement calloc simply by calling malloc and set zero */
+ * Implement calloc by calling malloc and set zero.
+ * With _NANO_MALLOC_ZEROED_SBRK, memory that sbrk returns for the first
+ * time is known to be zero, so only the part of the block below
+ * heap_fresh as it was before calling malloc is cleared.  The lock keeps
+ * other threads from using fresh memory in between.  */
 void * nano_calloc(RARG malloc_size_t n, malloc_size_t elem)
 {
-    void * mem = nano_malloc(RCALL n * elem);
-    if (mem != NULL) memset(mem, 0, n * elem);
+    malloc_size_t bytes;
+    void * mem;
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+    char * fresh;
+#endif
+
+    if (elem != 0 && n > MAX_ALLOC_SIZE / elem)
+    {
+        RERRNO = ENOMEM;
+        return NULL;
+    }
+    bytes = n * elem;
+
+#ifdef _NANO_MALLOC_ZEROED_SBRK
+    MALLOC_LOCK;
+    fresh = heap_fresh;
+    mem = nano_malloc(RCALL bytes);
+    MALLOC_UNLOCK;
+    if (mem != NULL && (char *)mem < fresh)
+    {
+        if ((char *)mem + bytes > fresh)
+            bytes = fresh - (char *)mem;
+        memset(mem, 0, bytes);
+    }
+#else
+    mem = nano_malloc(RCALL bytes);
+    if (mem != NULL) memset(mem, 0, bytes);
+#endif
     return mem;
 }
 #endif /* DEFINE_CALLOC */
@@ -399,14 +843,28 @@ void * nano_calloc(RARG malloc_size_t n, malloc_size_t elem)
 #ifdef DEFINE_REALLOC
 void * nano_malloc(RARG malloc_size_t s);
 void nano_free (RARG void * free_p);
-malloc_size_t nano_malloc_usable_size(RARG void * ptr);
+void * sbrk_aligned(RARG malloc_size_t s);
+extern chunk * free_list;
+extern char * sbrk_top;
 
 /* Function nano_realloc
- * Implement realloc by malloc + memcpy */
+ * Resize the chunk in place if possible, otherwise malloc + memcpy.
+ * Algorithm:
+ *   Compute the chunk size needed to hold size bytes from ptr.
+ *   Shrink: split the chunk and free the tail if it is big enough to
+ *           be a chunk.
+ *   Grow:   merge the free chunk immediately after it, if any.  If that
+ *           is not enough and the chunk or the merged free chunk ends at
+ *           the top of the heap, sbrk the missing bytes.  Split and put
+ *           back what is not needed.
+ *   Fall back to malloc + memcpy + free if none of these works.
+ */
 void * nano_realloc(RARG void * ptr, malloc_size_t size)
 {
     void * mem;
-    chunk * p_to_realloc;
+    chunk * c, * f, * prev, * r;
+    char * end, * top, * p;
+    malloc_size_t old_size, need, avail, grow;
 
     if (ptr == NULL) return nano_malloc(RCALL size);
 
@@ -415,23 +873,111 @@ void * nano_realloc(RARG void * ptr, malloc_size_t size)
         nano_free(RCALL ptr);
         return NULL;
     }
-    
-    /* TODO: There is chance to shrink the chunk if newly requested
-     * size is much small */
-    if (nano_malloc_usable_size(RCALL ptr) >= size)
-      return ptr;
+
+    if (size >= MAX_ALLOC_SIZE)
+    {
+        RERRNO = ENOMEM;
+        return NULL;
+    }
+
+    c = get_chunk_from_ptr(ptr);
+    end = (char *)c + c->size;
+    old_size = end - (char *)ptr;
+    need = ((char *)ptr - (char *)c) + ALIGN_TO(size, CHUNK_ALIGN);
+    need = max(need, MALLOC_MINCHUNK);
+
+    if (c->size >= need)
+    {
+        if (c->size - need >= MALLOC_MINCHUNK)
+        {
+            /* Shrink: give the tail back */
+            r = (chunk *)((char *)c + need);
+            r->size = c->size - need;
+            c->size = need;
+            nano_free(RCALL (char *)r + CHUNK_OFFSET);
+        }
+        return ptr;
+    }
+
+    MALLOC_LOCK;
+
+    /* Find the free chunk right after c, and the one before it */
+    prev = NULL;
+    f = free_list;
+    while (f != NULL && (char *)f < end)
+    {
+        prev = f;
+        f = f->next;
+    }
+    if ((char *)f != end)
+        f = NULL;
+
+    avail = c->size + (f != NULL ? f->size : 0);
+    top = f != NULL ? (char *)f + f->size : end;
+    mem = NULL;
+
+    if (avail < need && top == sbrk_top)
+    {
+        /* Take at least a minimal chunk, in case the memory cannot be
+         * merged and has to be freed on its own */
+        grow = max(need - avail, MALLOC_MINCHUNK);
+        p = sbrk_aligned(RCALL grow);
+        if (p == top)
+            avail += grow;
+        else if (p != (void *)-1)
+        {
+            /* Someone else moved the break.  Keep the new memory as a
+             * free chunk and fall back to copying */
+            mem = p;
+            ((chunk *)mem)->size = grow;
+        }
+    }
+
+    if (avail >= need)
+    {
+        /* Grow: take f out of free list, merge, and put the rest back
+         * between prev and the chunk after f */
+        if (f != NULL)
+        {
+            if (prev == NULL) free_list = f->next;
+            else prev->next = f->next;
+        }
+        c->size = avail;
+        if (avail - need >= MALLOC_MINCHUNK)
+        {
+            r = (chunk *)((char *)c + need);
+            r->size = avail - need;
+            c->size = need;
+            if (prev == NULL)
+            {
+                r->next = free_list;
+                free_list = r;
+            }
+            else
+            {
+                r->next = prev->next;
+                prev->next = r;
+            }
+        }
+        MALLOC_UNLOCK;
+        return ptr;
+    }
+    MALLOC_UNLOCK;
+
+    if (mem != NULL)
+        nano_free(RCALL (char *)mem + CHUNK_OFFSET);
 
     mem = nano_malloc(RCALL size);
     if (mem != NULL) 
     {
-        memcpy(mem, ptr, size);
+        memcpy(mem, ptr, old_size);
         nano_free(RCALL ptr);
     }
     return mem;
 }
 #endif /* DEFINE_REALLOC */
 
-#ifdef DEFINE_MALLINFO
+#if defined (DEFINE_MALLINFO) || defined (DEFINE_MALLOC_STATS)
 struct mallinfo {
   int arena;    /* total space allocated from system */
   int ordblks;  /* number of non-inuse chunks */
@@ -444,19 +990,108 @@ struct mallinfo {
   int fordblks; /* total non-inuse space */
   int keepcost; /* top-most, releasable (via malloc_trim) space */
 };
+#endif
+
+#ifdef DEFINE_MALLINFO
+extern chunk * free_list;
+#ifdef _NANO_MALLOC_BINS
+extern chunk * free_bins[];
+#endif
+extern malloc_size_t heap_arena;
+extern char * sbrk_top;
 
 static struct mallinfo current_mallinfo={0,0,0,0,0,0,0,0,0,0};
 
+static void mallinfo_add_free(chunk * c)
+{
+    current_mallinfo.ordblks++;
+    current_mallinfo.fordblks += c->size;
+    if ((char *)c + c->size == sbrk_top)
+        current_mallinfo.keepcost = c->size;
+}
+
+/* Function nano_mallinfo
+ * Walk through the free chunks to compute the statistics.  The only
+ * bookkeeping done by malloc itself is the total size obtained from
+ * sbrk.  */
 struct mallinfo nano_mallinfo(RONEARG)
 {
+    chunk * c;
+#ifdef _NANO_MALLOC_BINS
+    int i;
+#endif
+
+    MALLOC_LOCK;
+    current_mallinfo.ordblks = 0;
+    current_mallinfo.fordblks = 0;
+    current_mallinfo.keepcost = 0;
+
+    for (c = free_list; c != NULL; c = c->next)
+        mallinfo_add_free(c);
+#ifdef _NANO_MALLOC_BINS
+    for (i = 0; i < MALLOC_NBINS; i++)
+        for (c = free_bins[i]; c != NULL; c = c->next)
+            mallinfo_add_free(c);
+#endif
+
+    current_mallinfo.arena = heap_arena;
+    current_mallinfo.uordblks = heap_arena - current_mallinfo.fordblks;
+    MALLOC_UNLOCK;
     return current_mallinfo;
 }
 
 #endif /* DEFINE_MALLINFO */
 
 #ifdef DEFINE_MALLOC_STATS
+extern chunk * free_list;
+#ifdef _NANO_MALLOC_BINS
+extern chunk * free_bins[];
+#endif
+struct mallinfo nano_mallinfo(RONEARG);
+
+/* Function nano_malloc_stats
+ * Print heap statistics on standard error */
 void nano_malloc_stats(RONEARG)
 {
+    struct mallinfo current_mallinfo;
+    chunk * c;
+    int largest = 0;
+#ifdef INTERNAL_NEWLIB
+    FILE * fp;
+
+    _REENT_SMALL_CHECK_INIT(reent_ptr);
+    fp = _stderr_r(reent_ptr);
+#else
+    FILE * fp = stderr;
+#endif
+
+    current_mallinfo = nano_mallinfo(RONECALL);
+
+    MALLOC_LOCK;
+    for (c = free_list; c != NULL; c = c->next)
+        largest = max(largest, c->size);
+#ifdef _NANO_MALLOC_BINS
+    {
+        int i;
+
+        for (i = 0; i < MALLOC_NBINS; i++)
+            if (free_bins[i] != NULL)
+                largest = max(largest, free_bins[i]->size);
+    }
+#endif
+    MALLOC_UNLOCK;
+
+    fprintf(fp, "system bytes     = %10u\n",
+            (unsigned int)current_mallinfo.arena);
+    fprintf(fp, "in use bytes     = %10u\n",
+            (unsigned int)current_mallinfo.uordblks);
+    fprintf(fp, "free bytes       = %10u\n",
+            (unsigned int)current_mallinfo.fordblks);
+    fprintf(fp, "free chunks      = %10u\n",
+            (unsigned int)current_mallinfo.ordblks);
+    fprintf(fp, "largest free     = %10u\n", (unsigned int)largest);
+    fprintf(fp, "releasable bytes = %10u\n",
+            (unsigned int)current_mallinfo.keepcost);
 }
 #endif /* DEFINE_MALLOC_STATS */
 
@@ -546,9 +1181,299 @@ void * nano_memalign(RARG size_t align, size_t s)
 }
 #endif /* DEFINE_MEMALIGN */
 
+#ifdef DEFINE_MALLOC_WALK
+extern chunk * free_list;
+extern region heap_regions[];
+extern int heap_nregions;
+#ifdef _NANO_MALLOC_BINS
+int __malloc_consolidate(RONEARG);
+#endif
+
+/* Function nano_malloc_walk
+ * Call fn for every chunk of the heap, in address order within each
+ * region.  fn receives the chunk address, its total size including the
+ * chunk head, whether it is in use, and arg.  The walk stops when fn
+ * returns non-zero, and that value is returned.  fn is called with the
+ * malloc lock held and must not allocate or free memory.
+ * Return: 0 if all chunks were visited, -1 if a corrupted chunk size was
+ *         found, otherwise the value returned by fn.
+ * Algorithm: Chunks of a region are adjacent to each other, so they are
+ *            reached by adding up chunk sizes.  A chunk is free if it is
+ *            the next element of the address sorted free list.  Binned
+ *            chunks are merged into the free list first.
+ */
+int nano_malloc_walk(RARG int (*fn)(void *, size_t, int, void *), void * arg)
+{
+    chunk * c, * f;
+    char * end;
+    int i, ret = 0;
+
+    MALLOC_LOCK;
+#ifdef _NANO_MALLOC_BINS
+    __malloc_consolidate(RONECALL);
+#endif
+    for (i = 0; i < heap_nregions && ret == 0; i++)
+    {
+        c = (chunk *)heap_regions[i].start;
+        end = heap_regions[i].end;
+
+        f = free_list;
+        while (f != NULL && f < c) f = f->next;
+
+        while ((char *)c < end)
+        {
+            if (c->size < (int)MALLOC_MINCHUNK || (char *)c + c->size > end)
+            {
+                ret = -1;
+                break;
+            }
+            if (c == f)
+            {
+                f = f->next;
+                ret = fn(c, c->size, 0, arg);
+            }
+            else
+                ret = fn(c, c->size, 1, arg);
+            if (ret != 0)
+                break;
+            c = (chunk *)((char *)c + c->size);
+        }
+    }
+    MALLOC_UNLOCK;
+    return ret;
+}
+#endif /* DEFINE_MALLOC_WALK */
+
+#ifdef DEFINE_MALLOC_TRIM
+int __malloc_consolidate(RONEARG);
+int __malloc_tcache_flush(RONEARG);
+int __malloc_trim_top(RARG malloc_size_t pad, malloc_size_t threshold);
+
+/** Function nano_malloc_trim
+  * Return the free memory at the top of the heap to the system, keeping
+  * pad bytes.  Cached and binned chunks are merged back first so that
+  * the top free chunk is as large as possible.
+  */
+int nano_malloc_trim(RARG size_t pad)
+{
+    int ret;
+
+    MALLOC_LOCK;
+#ifdef _NANO_MALLOC_TCACHE
+    __malloc_tcache_flush(RONECALL);
+#endif
+#ifdef _NANO_MALLOC_BINS
+    __malloc_consolidate(RONECALL);
+#endif
+    ret = __malloc_trim_top(RCALL pad, 0);
+    MALLOC_UNLOCK;
+    return ret;
+}
+#endif /* DEFINE_MALLOC_TRIM */
+
+#ifdef DEFINE_MALLOC_REGION
+void nano_free (RARG void * free_p);
+extern chunk * free_list;
+extern region heap_regions[];
+extern int heap_nregions;
+extern malloc_size_t heap_arena;
+extern char * sbrk_top;
+#ifdef _NANO_MALLOC_BINS
+int __malloc_consolidate(RONEARG);
+#endif
+#ifdef _NANO_MALLOC_TCACHE
+int __malloc_tcache_flush(RONEARG);
+#endif
+
+/* Function nano_malloc_add_region
+ * Give the memory [start, start + size) to malloc.  It becomes a region
+ * of its own, and is added to the free list as one chunk.  Chunks never
+ * cross region boundaries, so memory adjacent to a region is merged into
+ * it instead.  If it fills the gap between two regions, the one after
+ * it is left empty.  The memory must not overlap the heap or start at
+ * the top of the sbrk heap.
+ * Return: the index of the region for malloc_region, or -1 with errno
+ *         set to EINVAL if the memory is too small or overlaps a region,
+ *         or to ENOMEM if the region table is full.
+ */
+int nano_malloc_add_region(RARG void * start, malloc_size_t size)
+{
+    char * p = (char *)ALIGN_TO((unsigned long)start, CHUNK_ALIGN);
+    chunk * c;
+    int i, r = -1, after = -1;
+
+    if (start == NULL || size < (malloc_size_t)(p - (char *)start)
+        + MALLOC_MINCHUNK || size >= MAX_ALLOC_SIZE)
+    {
+        RERRNO = EINVAL;
+        return -1;
+    }
+    size = (size - (p - (char *)start)) & ~(CHUNK_ALIGN - 1);
+
+    MALLOC_LOCK;
+    for (i = 0; i < heap_nregions; i++)
+    {
+        if ((p < heap_regions[i].end && p + size > heap_regions[i].start)
+            || p == sbrk_top)
+        {
+            /* sbrk would hand out memory at sbrk_top again */
+            MALLOC_UNLOCK;
+            RERRNO = EINVAL;
+            return -1;
+        }
+        if (heap_regions[i].start == heap_regions[i].end)
+            continue;
+        if (heap_regions[i].end == p)
+            r = i;
+        if (heap_regions[i].start == p + size)
+            after = i;
+    }
+
+    if (r >= 0)
+    {
+        heap_regions[r].end = p + size;
+        if (after >= 0)
+        {
+            heap_regions[r].end = heap_regions[after].end;
+            heap_regions[after].start = heap_regions[after].end;
+        }
+    }
+    else if (after >= 0)
+    {
+        r = after;
+        heap_regions[r].start = p;
+    }
+    else if (heap_nregions < MALLOC_MAX_REGIONS)
+    {
+        r = heap_nregions++;
+        heap_regions[r].start = p;
+        heap_regions[r].end = p + size;
+    }
+    else
+    {
+        MALLOC_UNLOCK;
+        RERRNO = ENOMEM;
+        return -1;
+    }
+
+    heap_arena += size;
+    c = (chunk *)p;
+    c->size = size;
+    nano_free(RCALL p + CHUNK_OFFSET);
+    MALLOC_UNLOCK;
+    return r;
+}
+
+/* Function nano_malloc_region
+ * Allocate like malloc, but only from the free chunks of region r, which
+ * is an index returned by malloc_add_region.  Never calls sbrk.
+ * Algorithm: first fit in the part of the sorted free list that lies in
+ *            the region, taking the tail of a bigger chunk.  Binned and
+ *            cached chunks are merged back before giving up.
+ */
+void * nano_malloc_region(RARG int r, malloc_size_t s)
+{
+    chunk *p, *c;
+    char * lo, * hi, * ptr, * align_ptr;
+    int offset;
+    malloc_size_t alloc_size;
+
+    alloc_size = ALIGN_TO(s, CHUNK_ALIGN);
+    alloc_size += MALLOC_PADDING;
+    alloc_size += CHUNK_OFFSET;
+    alloc_size = max(alloc_size, MALLOC_MINCHUNK);
+
+    if (alloc_size >= MAX_ALLOC_SIZE || alloc_size < s)
+    {
+        RERRNO = ENOMEM;
+        return NULL;
+    }
+
+    MALLOC_LOCK;
+    if (r < 0 || r >= heap_nregions)
+    {
+        MALLOC_UNLOCK;
+        RERRNO = EINVAL;
+        return NULL;
+    }
+    lo = heap_regions[r].start;
+    hi = heap_regions[r].end;
+
+#if defined (_NANO_MALLOC_BINS) || defined (_NANO_MALLOC_TCACHE)
+retry:
+#endif
+    p = NULL;
+    for (c = free_list; c != NULL && (char *)c < hi; p = c, c = c->next)
+    {
+        int rem;
+
+        if ((char *)c < lo)
+            continue;
+        rem = c->size - alloc_size;
+        if (rem < 0)
+            continue;
+        if (rem >= (int)MALLOC_MINCHUNK)
+        {
+            c->size = rem;
+            c = (chunk *)((char *)c + rem);
+            c->size = alloc_size;
+        }
+        else if (p == NULL)
+            free_list = c->next;
+        else
+            p->next = c->next;
+        break;
+    }
+
+    if (c == NULL || (char *)c >= hi)
+    {
+#ifdef _NANO_MALLOC_TCACHE
+        if (__malloc_tcache_flush(RONECALL))
+            goto retry;
+#endif
+#ifdef _NANO_MALLOC_BINS
+        if (__malloc_consolidate(RONECALL))
+            goto retry;
+#endif
+        MALLOC_UNLOCK;
+        RERRNO = ENOMEM;
+        return NULL;
+    }
+    MALLOC_UNLOCK;
+
+    ptr = (char *)c + CHUNK_OFFSET;
+    align_ptr = (char *)ALIGN_TO((unsigned long)ptr, MALLOC_ALIGN);
+    offset = align_ptr - ptr;
+    if (offset)
+        *(int *)((char *)c + offset) = -offset;
+    return align_ptr;
+}
+#endif /* DEFINE_MALLOC_REGION */
+
 #ifdef DEFINE_MALLOPT
+extern malloc_size_t trim_threshold;
+extern malloc_size_t top_pad;
+
+/* Same values as in malloc.h */
+#define M_TRIM_THRESHOLD    -1
+#define M_TOP_PAD           -2
+
+/** Function nano_mallopt
+  * Only M_TRIM_THRESHOLD and M_TOP_PAD are supported.  A threshold of 0
+  * or less turns automatic trimming off.
+  * Return: 1 if the parameter was set, 0 otherwise.
+  */
 int nano_mallopt(RARG int parameter_number, int parameter_value)
 {
+    switch (parameter_number)
+    {
+    case M_TRIM_THRESHOLD:
+        trim_threshold = parameter_value > 0 ? parameter_value : 0;
+        return 1;
+    case M_TOP_PAD:
+        top_pad = parameter_value > 0 ? parameter_value : 0;
+        return 1;
+    }
     return 0;
 }
 #endif /* DEFINE_MALLOPT */
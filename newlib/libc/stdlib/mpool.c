@@ -0,0 +1,222 @@
+/*
+FUNCTION
+<<malloc_pool_init>>, <<malloc_pool_alloc>>, <<malloc_pool_free>>, <<malloc_pool_destroy>>---pools of fixed-size objects
+
+INDEX
+	malloc_pool_init
+INDEX
+	malloc_pool_alloc
+INDEX
+	malloc_pool_free
+INDEX
+	malloc_pool_destroy
+INDEX
+	_malloc_pool_alloc_r
+INDEX
+	_malloc_pool_destroy_r
+
+ANSI_SYNOPSIS
+	#include <malloc.h>
+	void malloc_pool_init(struct malloc_pool *<[pool]>, size_t <[size]>,
+			void *<[buf]>, size_t <[n]>);
+	void *malloc_pool_alloc(struct malloc_pool *<[pool]>);
+	void malloc_pool_free(struct malloc_pool *<[pool]>, void *<[obj]>);
+	void malloc_pool_destroy(struct malloc_pool *<[pool]>);
+
+	void *_malloc_pool_alloc_r(void *<[reent]>,
+			struct malloc_pool *<[pool]>);
+	void _malloc_pool_destroy_r(void *<[reent]>,
+			struct malloc_pool *<[pool]>);
+
+TRAD_SYNOPSIS
+	#include <malloc.h>
+	void malloc_pool_init(<[pool]>, <[size]>, <[buf]>, <[n]>)
+	struct malloc_pool *<[pool]>;
+	size_t <[size]>;
+	char *<[buf]>;
+	size_t <[n]>;
+
+	char *malloc_pool_alloc(<[pool]>)
+	struct malloc_pool *<[pool]>;
+
+	void malloc_pool_free(<[pool]>, <[obj]>)
+	struct malloc_pool *<[pool]>;
+	char *<[obj]>;
+
+	void malloc_pool_destroy(<[pool]>)
+	struct malloc_pool *<[pool]>;
+
+	char *_malloc_pool_alloc_r(<[reent]>, <[pool]>)
+	char *<[reent]>;
+	struct malloc_pool *<[pool]>;
+
+	void _malloc_pool_destroy_r(<[reent]>, <[pool]>)
+	char *<[reent]>;
+	struct malloc_pool *<[pool]>;
+
+DESCRIPTION
+A pool hands out objects of one size in constant time, without the
+per-block header and the free list search of <<malloc>>.  Free objects
+are kept on a stack threaded through the objects themselves.
+
+<<malloc_pool_init>> prepares <[pool]> for objects of <[size]> bytes.
+If <[buf]> is not NULL, the pool is made of the <[n]> objects in
+<[buf]>, which must hold <[n]> times <<MALLOC_POOL_OBJSIZE>>(<[size]>)
+bytes and be aligned for any object; such a pool never grows.  If
+<[buf]> is NULL, the pool starts empty and calls <<malloc>> for
+<[n]> more objects at a time whenever it runs out.
+
+<<malloc_pool_alloc>> returns a free object of the pool.
+
+<<malloc_pool_free>> gives <[obj]> back to <[pool]>.  Memory obtained
+from <<malloc>> is kept by the pool for later allocations.
+
+<<malloc_pool_destroy>> frees the memory the pool obtained from
+<<malloc>>.  Objects of the pool must not be used afterwards.  The pool
+is left empty; a pool that gets its memory from <<malloc>> can still be
+used and grows again as needed.
+
+The fields <<nobjs>>, <<nused>> and <<maxused>> of the pool structure
+give the number of objects owned by the pool, currently allocated, and
+the largest number allocated at the same time.
+
+The pool functions do no locking of their own.
+
+The alternate functions <<_malloc_pool_alloc_r>> and
+<<_malloc_pool_destroy_r>> are reentrant versions.  The extra argument
+<[reent]> is a pointer to a reentrancy structure.
+
+RETURNS
+<<malloc_pool_alloc>> returns a pointer to the object, or NULL if the
+pool is empty and can not grow.
+
+PORTABILITY
+The pool functions are not portable.
+*/
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include <errno.h>
+
+/* Every block obtained from malloc starts with a link to the next one */
+#define BLOCK_HEADER MALLOC_POOL_OBJSIZE (sizeof (_PTR))
+
+static _VOID
+_DEFUN (pool_push, (pool, buf, n),
+	struct malloc_pool *pool _AND
+	char *buf _AND
+	size_t n)
+{
+  char *obj;
+
+  /* Push from the end so that objects are handed out in address order */
+  for (obj = buf + n * pool->_size; obj != buf; )
+    {
+      obj -= pool->_size;
+      *(_PTR *) obj = pool->_free;
+      pool->_free = obj;
+    }
+  pool->nobjs += n;
+}
+
+_VOID
+_DEFUN (malloc_pool_init, (pool, size, buf, n),
+	struct malloc_pool *pool _AND
+	size_t size _AND
+	_PTR buf _AND
+	size_t n)
+{
+  pool->_free = NULL;
+  pool->_blocks = NULL;
+  pool->_size = MALLOC_POOL_OBJSIZE (size);
+  if (pool->_size < BLOCK_HEADER)
+    pool->_size = BLOCK_HEADER;
+  pool->_grow = buf == NULL ? n : 0;
+  pool->nobjs = 0;
+  pool->nused = 0;
+  pool->maxused = 0;
+  if (buf != NULL)
+    pool_push (pool, buf, n);
+}
+
+_PTR
+_DEFUN (_malloc_pool_alloc_r, (ptr, pool),
+	struct _reent *ptr _AND
+	struct malloc_pool *pool)
+{
+  _PTR *obj = pool->_free;
+  char *block;
+
+  if (obj == NULL)
+    {
+      if (pool->_grow == 0
+	  || pool->_grow > ((size_t) -1 - BLOCK_HEADER) / pool->_size)
+	{
+	  ptr->_errno = ENOMEM;
+	  return NULL;
+	}
+      block = _malloc_r (ptr, BLOCK_HEADER + pool->_grow * pool->_size);
+      if (block == NULL)
+	return NULL;
+      *(_PTR *) block = pool->_blocks;
+      pool->_blocks = block;
+      pool_push (pool, block + BLOCK_HEADER, pool->_grow);
+      obj = pool->_free;
+    }
+
+  pool->_free = *obj;
+  if (++pool->nused > pool->maxused)
+    pool->maxused = pool->nused;
+  return obj;
+}
+
+_VOID
+_DEFUN (malloc_pool_free, (pool, obj),
+	struct malloc_pool *pool _AND
+	_PTR obj)
+{
+  if (obj == NULL)
+    return;
+  *(_PTR *) obj = pool->_free;
+  pool->_free = obj;
+  pool->nused--;
+}
+
+_VOID
+_DEFUN (_malloc_pool_destroy_r, (ptr, pool),
+	struct _reent *ptr _AND
+	struct malloc_pool *pool)
+{
+  _PTR block;
+  _PTR next;
+
+  for (block = pool->_blocks; block != NULL; block = next)
+    {
+      next = *(_PTR *) block;
+      _free_r (ptr, block);
+    }
+  pool->_blocks = NULL;
+  pool->_free = NULL;
+  pool->nobjs = 0;
+  pool->nused = 0;
+}
+
+#ifndef _REENT_ONLY
+
+_PTR
+_DEFUN (malloc_pool_alloc, (pool),
+	struct malloc_pool *pool)
+{
+  return _malloc_pool_alloc_r (_REENT, pool);
+}
+
+_VOID
+_DEFUN (malloc_pool_destroy, (pool),
+	struct malloc_pool *pool)
+{
+  _malloc_pool_destroy_r (_REENT, pool);
+}
+
+#endif
@@ -93,6 +93,73 @@
 #define _Kmax 15
 */
 
+#ifdef _NANO_MPREC_ARENA
+
+/* With _NANO_MPREC_ARENA, the big numbers and the free list of each
+   thread are carved from an arena given with _mprec_arena_r and are
+   never given back, just like the memory Balloc gets from calloc
+   otherwise.  The global reent uses a static arena of
+   _MPREC_ARENA_SIZE bytes.  The default is enough for printf of any
+   double with a precision of up to 40 and strtod of up to 40
+   significant digits.  Numbers that do not fit any more come from
+   calloc, as do those of threads without an arena.  */
+
+#ifndef _MPREC_ARENA_SIZE
+#define _MPREC_ARENA_SIZE (3584 + (_Kmax + 1) * sizeof (_PTR))
+#endif
+
+#define MP_ALIGN 8
+
+static double global_arena[_MPREC_ARENA_SIZE / sizeof (double)];
+
+_VOID
+_DEFUN (_mprec_arena_r, (ptr, buf, size),
+	struct _reent *ptr _AND
+	_PTR buf _AND
+	size_t size)
+{
+  char *p;
+
+  p = (char *) (((size_t) buf + MP_ALIGN - 1) & ~(size_t) (MP_ALIGN - 1));
+
+  ptr->_mp_arena._base = ptr->_mp_arena._next = p;
+  ptr->_mp_arena._end = p + (size - (p - (char *) buf));
+}
+
+static _PTR
+_DEFUN (mp_calloc, (ptr, n, size),
+	struct _reent *ptr _AND
+	size_t n _AND
+	size_t size)
+{
+  struct __mprec_arena *arena = &ptr->_mp_arena;
+  char *p;
+
+  if (arena->_base == NULL && ptr == _GLOBAL_REENT)
+    _mprec_arena_r (ptr, global_arena, sizeof (global_arena));
+  size = (n * size + MP_ALIGN - 1) & ~(MP_ALIGN - 1);
+  p = arena->_next;
+  if (p == NULL || (size_t) (arena->_end - p) < size)
+    return _calloc_r (ptr, 1, size);
+  arena->_next = p + size;
+  return memset (p, 0, size);
+}
+
+#ifdef _REENT_SMALL
+struct _mprec *
+_DEFUN (__mprec_state, (ptr), struct _reent *ptr)
+{
+  ptr->_mp = (struct _mprec *) mp_calloc (ptr, 1, sizeof (struct _mprec));
+  if (ptr->_mp != NULL)
+    _REENT_INIT_MP (ptr);
+  return ptr->_mp;
+}
+#endif
+
+#else /* !_NANO_MPREC_ARENA */
+#define mp_calloc _calloc_r
+#endif /* !_NANO_MPREC_ARENA */
+
 _Bigint *
 _DEFUN (Balloc, (ptr, k), struct _reent *ptr _AND int k)
 {
@@ -103,7 +170,7 @@ _DEFUN (Balloc, (ptr, k), struct _reent *ptr _AND int k)
   if (_REENT_MP_FREELIST(ptr) == NULL)
     {
       /* Allocate a list of pointers to the mprec objects */
-      _REENT_MP_FREELIST(ptr) = (struct _Bigint **) _calloc_r (ptr, 
+      _REENT_MP_FREELIST(ptr) = (struct _Bigint **) mp_calloc (ptr, 
 						      sizeof (struct _Bigint *),
 						      _Kmax + 1);
       if (_REENT_MP_FREELIST(ptr) == NULL)
@@ -120,7 +187,7 @@ _DEFUN (Balloc, (ptr, k), struct _reent *ptr _AND int k)
     {
       x = 1 << k;
       /* Allocate an mprec Bigint and stick in in the freelist */
-      rv = (_Bigint *) _calloc_r (ptr,
+      rv = (_Bigint *) mp_calloc (ptr,
 				  1,
 				  sizeof (_Bigint) +
 				  (x-1) * sizeof(rv->_x));
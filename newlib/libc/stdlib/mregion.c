@@ -0,0 +1,104 @@
+/*
+FUNCTION
+<<malloc_add_region>>, <<malloc_region>>---more memory for malloc
+
+INDEX
+	malloc_add_region
+INDEX
+	malloc_region
+INDEX
+	_malloc_add_region_r
+INDEX
+	_malloc_region_r
+
+ANSI_SYNOPSIS
+	#include <malloc.h>
+	int malloc_add_region(void *<[start]>, size_t <[size]>);
+	void *malloc_region(int <[region]>, size_t <[nbytes]>);
+
+	int _malloc_add_region_r(void *<[reent]>, void *<[start]>,
+			size_t <[size]>);
+	void *_malloc_region_r(void *<[reent]>, int <[region]>,
+			size_t <[nbytes]>);
+
+TRAD_SYNOPSIS
+	#include <malloc.h>
+	int malloc_add_region(<[start]>, <[size]>)
+	char *<[start]>;
+	size_t <[size]>;
+
+	char *malloc_region(<[region]>, <[nbytes]>)
+	int <[region]>;
+	size_t <[nbytes]>;
+
+	int _malloc_add_region_r(<[reent]>, <[start]>, <[size]>)
+	char *<[reent]>;
+	char *<[start]>;
+	size_t <[size]>;
+
+	char *_malloc_region_r(<[reent]>, <[region]>, <[nbytes]>)
+	char *<[reent]>;
+	int <[region]>;
+	size_t <[nbytes]>;
+
+DESCRIPTION
+<<malloc_add_region>> gives the <[size]> bytes of memory at <[start]>
+to the allocator, in addition to the memory it obtains with <<sbrk>>.
+This lets <<malloc>> use several discontiguous banks of RAM.  The memory
+must not overlap the heap, must not directly follow the end of the
+<<sbrk>> heap, and can not be taken back.
+
+<<malloc>>, <<realloc>> and the other allocation functions use the free
+memory of all regions, lowest addresses first.  <<malloc_region>>
+allocates <[nbytes]> bytes like <<malloc>>, but only from the region
+<[region]> returned by <<malloc_add_region>>, for example to place a
+buffer in fast or DMA capable memory.  It never asks <<sbrk>> for more
+memory.  The block is freed with <<free>> as usual.
+
+Up to <<MALLOC_MAX_REGIONS>>, 8 by default, regions are recorded,
+including the ones of the <<sbrk>> heap.  Memory that directly follows
+a region given to <<malloc_add_region>> extends that region.
+
+The alternate functions <<_malloc_add_region_r>> and
+<<_malloc_region_r>> are reentrant versions.  The extra argument
+<[reent]> is a pointer to a reentrancy structure.
+
+RETURNS
+<<malloc_add_region>> returns the number of the region, or -1 if
+<[size]> is too small or the memory overlaps a region (<<errno>> is set
+to <<EINVAL>>), or if there are too many regions (<<errno>> is set to
+<<ENOMEM>>).
+
+<<malloc_region>> returns a pointer to the allocated space, or NULL if
+the region has no free block big enough (<<errno>> is set to
+<<ENOMEM>>) or <[region]> is not a region (<<errno>> is set to
+<<EINVAL>>).
+
+PORTABILITY
+<<malloc_add_region>> and <<malloc_region>> are newlib-nano extensions.
+*/
+
+#include <_ansi.h>
+#include <reent.h>
+#include <stdlib.h>
+#include <malloc.h>
+
+#ifndef _REENT_ONLY
+
+int
+_DEFUN (malloc_add_region, (start, size),
+	_PTR start _AND
+	size_t size)
+{
+  return _malloc_add_region_r (_REENT, start, size);
+}
+
+_PTR
+_DEFUN (malloc_region, (region, nbytes),
+	int region _AND
+	size_t nbytes)
+{
+  return _malloc_region_r (_REENT, region, nbytes);
+}
+
+#endif
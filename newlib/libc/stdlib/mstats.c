@@ -10,7 +10,7 @@ int _dummy_mstats = 1;
 
 /*
 FUNCTION
-<<mallinfo>>, <<malloc_stats>>, <<mallopt>>---malloc support
+<<mallinfo>>, <<malloc_stats>>, <<mallopt>>, <<malloc_walk>>---malloc support
 
 INDEX
 	mallinfo
@@ -18,22 +18,31 @@ INDEX
 	malloc_stats
 INDEX
 	mallopt
+INDEX
+	malloc_walk
 INDEX
 	_mallinfo_r
 INDEX
 	_malloc_stats_r
 INDEX
 	_mallopt_r
+INDEX
+	_malloc_walk_r
 
 ANSI_SYNOPSIS
 	#include <malloc.h>
 	struct mallinfo mallinfo(void);
 	void malloc_stats(void);
 	int mallopt(int <[parameter]>, <[value]>);
+	int malloc_walk(int (*<[fn]>)(void *, size_t, int, void *),
+			void *<[arg]>);
 
 	struct mallinfo _mallinfo_r(void *<[reent]>);
 	void _malloc_stats_r(void *<[reent]>);
 	int _mallopt_r(void *<[reent]>, int <[parameter]>, <[value]>);
+	int _malloc_walk_r(void *<[reent]>,
+			int (*<[fn]>)(void *, size_t, int, void *),
+			void *<[arg]>);
 
 TRAD_SYNOPSIS
 	#include <malloc.h>
@@ -45,6 +54,10 @@ TRAD_SYNOPSIS
 	int <[parameter]>;
 	int <[value]>;
 
+	int malloc_walk(<[fn]>, <[arg]>)
+	int (*<[fn]>)();
+	char *<[arg]>;
+
 	struct mallinfo _mallinfo_r(<[reent]>);
 	char *<[reent]>;
 
@@ -56,6 +69,11 @@ TRAD_SYNOPSIS
 	int <[parameter]>;
 	int <[value]>;
 
+	int _malloc_walk_r(<[reent]>, <[fn]>, <[arg]>)
+	char *<[reent]>;
+	int (*<[fn]>)();
+	char *<[arg]>;
+
 DESCRIPTION
 <<mallinfo>> returns a structure describing the current state of
 memory allocation.  The structure is defined in malloc.h.  The
@@ -66,7 +84,7 @@ in the heap; <<ordblks>> is the number of chunks which are not in use;
 the size of the top most memory block.
 
 <<malloc_stats>> print some statistics about memory allocation on
-standard error.
+standard error, including the size of the largest free block.
 
 <<mallopt>> takes a parameter and a value.  The parameters are defined
 in malloc.h, and may be one of the following: <<M_TRIM_THRESHOLD>>
@@ -76,8 +94,14 @@ calling <<_sbrk_r>> with a negative argument); <<M_TOP_PAD>> is the
 amount of padding to allocate whenever <<_sbrk_r>> is called to
 allocate more space.
 
-The alternate functions <<_mallinfo_r>>, <<_malloc_stats_r>>, and
-<<_mallopt_r>> are reentrant versions.  The extra argument <[reent]>
+<<malloc_walk>> calls <[fn]> once for every chunk in the heap, passing
+the address of the chunk, its size including the chunk header, non-zero
+if the chunk is in use, and <[arg]>.  The walk stops as soon as <[fn]>
+returns a non-zero value.  <[fn]> is called with the heap locked and
+must not allocate or free memory.
+
+The alternate functions <<_mallinfo_r>>, <<_malloc_stats_r>>,
+<<_mallopt_r>> and <<_malloc_walk_r>> are reentrant versions.  The extra argument <[reent]>
 is a pointer to a reentrancy structure.
 
 RETURNS
@@ -89,10 +113,13 @@ in malloc.h.
 <<mallopt>> returns zero if the parameter could not be set, or
 non-zero if it could be set.
 
+<<malloc_walk>> returns zero if every chunk was visited, -1 if a
+corrupted chunk was found, or the non-zero value returned by <[fn]>.
+
 PORTABILITY
 <<mallinfo>> and <<mallopt>> are provided by SVR4, but <<mallopt>>
-takes different parameters on different systems.  <<malloc_stats>> is
-not portable.
+takes different parameters on different systems.  <<malloc_stats>> and
+<<malloc_walk>> are not portable.
 
 */
 
@@ -125,6 +152,14 @@ _DEFUN (mallopt, (p, v),
   return _mallopt_r (_REENT, p, v);
 }
 
+int
+_DEFUN (malloc_walk, (fn, arg),
+	int (*fn) (_PTR, size_t, int, _PTR) _AND
+	_PTR arg)
+{
+  return _malloc_walk_r (_REENT, fn, arg);
+}
+
 #endif /* !_ELIX_LEVEL || _ELIX_LEVEL >= 2 */
 
 #endif
@@ -83,6 +83,44 @@ _DEFUN (memmem, (haystack_start, haystack_len, needle_start, needle_len),
   if (haystack_len < needle_len)
     return NULL;
 
+  if (needle_len <= SHORT_NEEDLE_THRESHOLD)
+    {
+      /* Last place the needle can start, and its end bytes.  */
+      const unsigned char *last = haystack + haystack_len - needle_len;
+      unsigned char first_byte = needle[0];
+      unsigned char last_byte = needle[needle_len - 1];
+      size_t i;
+
+      if (needle_len == 1)
+	return memchr (haystack, first_byte, haystack_len);
+      for (; haystack <= last; haystack++)
+	{
+	  /* Step over a few bytes here before asking memchr, which only
+	     pays off when the first byte is rare.  */
+	  for (i = 0; *haystack != first_byte; i++)
+	    {
+	      if (i == 4)
+		{
+		  haystack = memchr (haystack, first_byte,
+				     last + 1 - haystack);
+		  if (!haystack)
+		    return NULL;
+		  break;
+		}
+	      if (++haystack > last)
+		return NULL;
+	    }
+	  if (haystack[needle_len - 1] == last_byte)
+	    {
+	      for (i = 1; i < needle_len - 1 && haystack[i] == needle[i]; i++)
+		;
+	      if (i == needle_len - 1)
+		return (void *) haystack;
+	    }
+	}
+      return NULL;
+    }
+
   /* Use optimizations in memchr when possible, to reduce the search
      size of haystack using a linear algorithm with a smaller
      coefficient.  However, avoid memchr for long needles, since we
@@ -90,8 +128,8 @@ _DEFUN (memmem, (haystack_start, haystack_len, needle_start, needle_len),
   if (needle_len < LONG_NEEDLE_THRESHOLD)
     {
       haystack = memchr (haystack, *needle, haystack_len);
-      if (!haystack || needle_len == 1)
-	return (void *) haystack;
+      if (!haystack)
+	return NULL;
       haystack_len -= haystack - (const unsigned char *) haystack_start;
       if (haystack_len < needle_len)
 	return NULL;
@@ -26,7 +26,7 @@
 				be an 'unsigned char' as well.
 
   This file undefines the macros documented above, and defines
-  LONG_NEEDLE_THRESHOLD.
+  SHORT_NEEDLE_THRESHOLD and LONG_NEEDLE_THRESHOLD.
 */
 
 #include <limits.h>
@@ -42,6 +42,12 @@
    and http://en.wikipedia.org/wiki/Boyer-Moore_string_search_algorithm
 */
 
+/* Needles of at most this length are not worth a factorization.  The
+   callers search for them directly, trying each occurrence of the
+   first byte that the last byte confirms; with so few bytes to compare
+   at each position, that is still linear.  */
+#define SHORT_NEEDLE_THRESHOLD 8U
+
 /* Point at which computing a bad-byte shift table is likely to be
    worthwhile.  Small needles should not compute a table, since it
    adds (1 << CHAR_BIT) + NEEDLE_LEN computations of preparation for a
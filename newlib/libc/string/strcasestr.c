@@ -133,6 +133,35 @@ strcasestr(s, find)
   if (ok)
     return (char *) s;
   needle_len = needle - find;
+  if (needle_len <= SHORT_NEEDLE_THRESHOLD)
+    {
+      /* No byte before END is the terminating null.  */
+      const char *end = haystack;
+      int first = tolower ((unsigned char) find[0]);
+      int last = tolower ((unsigned char) find[needle_len - 1]);
+      size_t i;
+
+      for (haystack = s + 1;; haystack++)
+	{
+	  while (tolower ((unsigned char) *haystack) != first)
+	    if (*haystack++ == '\0')
+	      return NULL;
+	  if (end <= haystack)
+	    end = haystack + 1;
+	  while (end < haystack + needle_len)
+	    if (*end++ == '\0')
+	      return NULL;
+	  if (tolower ((unsigned char) haystack[needle_len - 1]) == last)
+	    {
+	      for (i = 1; i < needle_len - 1
+		     && (tolower ((unsigned char) haystack[i])
+			 == tolower ((unsigned char) find[i])); i++)
+		;
+	      if (i >= needle_len - 1)
+		return (char *) haystack;
+	    }
+	}
+    }
   haystack = s + 1;
   haystack_len = needle_len - 1;
 
@@ -101,9 +101,48 @@ _DEFUN (strstr, (searchee, lookfor),
   if (ok)
     return (char *) searchee;
 
+  needle_len = needle - lookfor;
+  if (needle_len <= SHORT_NEEDLE_THRESHOLD && needle_len > 1)
+    {
+      /* No byte before END is the terminating null.  */
+      const char *end = haystack;
+      char first = lookfor[0];
+      char last = lookfor[needle_len - 1];
+      size_t i;
+
+      for (haystack = searchee + 1;; haystack++)
+	{
+	  /* Step over a few bytes here before asking strchr, which only
+	     pays off when the first byte is rare.  */
+	  for (i = 0; *haystack != first; i++)
+	    {
+	      if (i == 4)
+		{
+		  haystack = strchr (haystack, first);
+		  if (!haystack)
+		    return NULL;
+		  break;
+		}
+	      if (*haystack++ == '\0')
+		return NULL;
+	    }
+	  if (end <= haystack)
+	    end = haystack + 1;
+	  while (end < haystack + needle_len)
+	    if (*end++ == '\0')
+	      return NULL;
+	  if (haystack[needle_len - 1] == last)
+	    {
+	      for (i = 1; i < needle_len - 1 && haystack[i] == lookfor[i]; i++)
+		;
+	      if (i == needle_len - 1)
+		return (char *) haystack;
+	    }
+	}
+    }
+
   /* Reduce the size of haystack using strchr, since it has a smaller
      linear coefficient than the Two-Way algorithm.  */
-  needle_len = needle - lookfor;
   haystack = strchr (searchee + 1, *lookfor);
   if (!haystack || needle_len == 1)
     return (char *) haystack;
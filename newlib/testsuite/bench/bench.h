@@ -0,0 +1,107 @@
+/* Timing for the benchmarks in this directory.
+
+   bench_now returns a cycle count where user code can read one (x86,
+   and Cortex-M3 and later through the DWT), and clock () elsewhere.
+   Call bench_init once before the first bench_now.
+
+   BENCH_BEST runs a statement N times, RUNS times over, and keeps the
+   least time, so that interrupts and cold caches do not count.  */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <time.h>
+
+#if defined (__x86_64__) || defined (__i386__)
+
+#define BENCH_UNIT "cycles"
+typedef unsigned long long bench_t;
+
+#define bench_init()
+
+static inline bench_t
+bench_now (void)
+{
+  unsigned int lo, hi;
+
+  __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+  return ((bench_t) hi << 32) | lo;
+}
+
+#elif defined (__ARM_ARCH_7M__) || defined (__ARM_ARCH_7EM__) \
+      || defined (__ARM_ARCH_8M_MAIN__)
+
+/* The counter is 32 bits, so no single run may take more than 2^32
+   cycles; differences wrap correctly in an unsigned long.  */
+#define BENCH_UNIT "cycles"
+typedef unsigned long bench_t;
+
+#define DEMCR		(*(volatile unsigned long *) 0xe000edfc)
+#define DWT_CTRL	(*(volatile unsigned long *) 0xe0001000)
+#define DWT_CYCCNT	(*(volatile unsigned long *) 0xe0001004)
+
+static inline void
+bench_init (void)
+{
+  DEMCR |= 1UL << 24;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= 1;
+}
+
+static inline bench_t
+bench_now (void)
+{
+  return DWT_CYCCNT;
+}
+
+#else
+
+#define BENCH_UNIT "clock ticks"
+typedef unsigned long bench_t;
+
+#define bench_init()
+
+static inline bench_t
+bench_now (void)
+{
+  return (bench_t) clock ();
+}
+
+#endif
+
+/* Set BEST to the least time taken by RUNS runs of N executions of
+   STMT.  */
+#define BENCH_BEST(best, runs, n, stmt)			\
+  do							\
+    {							\
+      int bench_r_;					\
+      long bench_i_;					\
+      bench_t bench_t_;					\
+							\
+      (best) = (bench_t) -1;				\
+      for (bench_r_ = 0; bench_r_ < (runs); bench_r_++)	\
+	{						\
+	  bench_t_ = bench_now ();			\
+	  for (bench_i_ = 0; bench_i_ < (n); bench_i_++)	\
+	    stmt;					\
+	  bench_t_ = bench_now () - bench_t_;		\
+	  if (bench_t_ < (best))			\
+	    (best) = bench_t_;				\
+	}						\
+    }							\
+  while (0)
+
+/* Print T / N with one decimal, right aligned in WIDTH columns.  The
+   nano printf need not have %f or %llu, so this uses neither.  */
+static void
+bench_print (int width, bench_t t, long n)
+{
+  char buf[32];
+  unsigned long tenths = (unsigned long) ((t * 10 + n / 2) / n);
+
+  sprintf (buf, "%lu.%lu", tenths / 10, tenths % 10);
+  printf ("%*s", width, buf);
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,58 @@
+/* Time blog_printf against snprintf on the same calls, and the
+   decoding of a record with blog_snprintf.  The ring is big enough to
+   hold every record of a row, so that none is dropped.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+asm (".global _printf_float");
+
+#define N 1000
+#define RUNS 5
+
+#define LOG "[%s] %s:%d: connection from %s accepted, fd=%d\n", \
+	    "INFO", "server.c", i, "192.168.1.100", 7
+#define TABLE "%-12s|%8d|%08x|%20s|\n", \
+	      "sensor", i, i * 77, "temperature ok"
+#define INTS "t=%u v=%d/%d/%d err=%x\n", (unsigned) i, i, -i, 3 * i, i
+#define FLOATS "temp %.2f C, load %.1f%%\n", 21.5 + i, 0.75
+
+static unsigned char ring[1 << 20];
+static blog_t lg;
+static char buf[256];
+
+#define ROW(name, stmt)						\
+  do								\
+    {								\
+      blog_init (&lg, ring, sizeof (ring));			\
+      BENCH_BEST (t, RUNS, N, (stmt, i++));			\
+      printf ("%-20s", name);					\
+      bench_print (8, t, N);					\
+      printf (lg._dropped != 0 ? " (dropped records)\n" : "\n");	\
+    }								\
+  while (0)
+
+int
+main (void)
+{
+  unsigned char rec[BLOG_RECMAX];
+  bench_t t;
+  int i = 0, len;
+
+  bench_init ();
+  printf (BENCH_UNIT " per call\n");
+  ROW ("snprintf    log", snprintf (buf, sizeof (buf), LOG));
+  ROW ("blog_printf log", blog_printf (&lg, LOG));
+  ROW ("snprintf    table", snprintf (buf, sizeof (buf), TABLE));
+  ROW ("blog_printf table", blog_printf (&lg, TABLE));
+  ROW ("snprintf    ints", snprintf (buf, sizeof (buf), INTS));
+  ROW ("blog_printf ints", blog_printf (&lg, INTS));
+  ROW ("snprintf    floats", snprintf (buf, sizeof (buf), FLOATS));
+  ROW ("blog_printf floats", blog_printf (&lg, FLOATS));
+
+  blog_init (&lg, ring, sizeof (ring));
+  blog_printf (&lg, LOG);
+  len = blog_read (&lg, rec, sizeof (rec));
+  ROW ("blog_snprintf log", blog_snprintf (buf, sizeof (buf), NULL, rec, len));
+  return 0;
+}
@@ -0,0 +1,52 @@
+/* Allocate N blocks of 1MB with calloc from fresh sbrk memory, free
+   them, and allocate them again, printing the time per call each time.
+   Compare a default build with one configured with
+   --enable-newlib-nano-malloc-zeroed-sbrk, on a system whose sbrk
+   returns zeroed memory.  The recycled calls are cleared either way;
+   with zeroed-sbrk they also take the page faults that the fresh calls
+   did not.  */
+
+#include <stdlib.h>
+#include "bench.h"
+
+#define N 256
+#define SIZE (1024 * 1024)
+
+static char *p[N];
+
+static void
+run (const char *what)
+{
+  bench_t t;
+  int i;
+
+  t = bench_now ();
+  for (i = 0; i < N; i++)
+    {
+      p[i] = calloc (SIZE, 1);
+      if (p[i] == NULL)
+	{
+	  printf ("calloc failed\n");
+	  exit (1);
+	}
+      /* Touch a page, as a program would, without reading the rest.  */
+      p[i][i * 4096] = 1;
+    }
+  t = bench_now () - t;
+  printf ("%s", what);
+  bench_print (12, t, N);
+  printf (" " BENCH_UNIT " per call\n");
+}
+
+int
+main (void)
+{
+  int i;
+
+  bench_init ();
+  run ("fresh memory    ");
+  for (i = 0; i < N; i++)
+    free (p[i]);
+  run ("recycled memory ");
+  return 0;
+}
@@ -0,0 +1,65 @@
+/* Time snprintf and sscanf on random floats of magnitude 2^-27 to
+   2^32, and print the time per call.  Build it once as is, which links
+   _printf_float and _scanf_float, and once with -DFLOAT32, which links
+   _printf_float32 and _scanf_float32.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+#ifdef FLOAT32
+asm (".global _printf_float32");
+asm (".global _scanf_float32");
+#else
+asm (".global _printf_float");
+asm (".global _scanf_float");
+#endif
+
+#define N 1024
+#define RUNS 5
+
+static float val[N];
+static char str[N][32];
+static char buf[128];
+
+static const char *const fmts[] = { "%f", "%e", "%g", "%.9g" };
+
+int
+main (void)
+{
+  union { float f; unsigned int u; } u;
+  unsigned int x = 12345;
+  float f;
+  bench_t t;
+  int i, k;
+
+  bench_init ();
+  for (i = 0; i < N; i++)
+    {
+      x = x * 1103515245 + 12345;
+      u.u = (x & 0x807fffff) | ((100 + (x >> 8) % 60) << 23);
+      val[i] = u.f;
+    }
+#ifdef FLOAT32
+  printf ("float32, " BENCH_UNIT " per call\n");
+#else
+  printf ("double, " BENCH_UNIT " per call\n");
+#endif
+  for (k = 0; k < (int) (sizeof (fmts) / sizeof (fmts[0])); k++)
+    {
+      i = 0;
+      BENCH_BEST (t, RUNS, N,
+		  snprintf (buf, sizeof (buf), fmts[k], val[i++ % N]));
+      printf ("%-10s", fmts[k]);
+      bench_print (8, t, N);
+      printf ("\n");
+    }
+
+  for (i = 0; i < N; i++)
+    snprintf (str[i], sizeof (str[i]), "%.7g", val[i]);
+  i = 0;
+  BENCH_BEST (t, RUNS, N, sscanf (str[i++ % N], "%f", &f));
+  printf ("%-10s", "scanf %f");
+  bench_print (8, t, N);
+  printf ("\n");
+  return 0;
+}
@@ -0,0 +1,64 @@
+/* Open more and more streams with funopen, then close and reopen
+   random ones, and print the number of glue blocks holding the FILEs
+   and the time per open while growing and per close and reopen.  The
+   growth is timed once, the close and reopen is the best of RUNS.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <reent.h>
+#include "bench.h"
+
+#define MAXOPEN 4000
+#define CHURN 20000L
+#define RUNS 5
+
+static FILE *fp[MAXOPEN];
+
+static int
+source (void *cookie, char *p, int n)
+{
+  return 0;
+}
+
+static int
+nglue (void)
+{
+  struct _glue *g;
+  int n = 0;
+
+  for (g = &_GLOBAL_REENT->__sglue; g != NULL; g = g->_next)
+    n++;
+  return n;
+}
+
+int
+main (void)
+{
+  static const int counts[] = { 10, 100, 1000, MAXOPEN };
+  int j, k, n = 0, start;
+  bench_t t, topen;
+
+  bench_init ();
+  srand (1);
+  printf ("%8s%8s%16s%16s\n", "files", "glue", "open growing", "close+open");
+  for (k = 0; k < (int) (sizeof (counts) / sizeof (counts[0])); k++)
+    {
+      start = n;
+      topen = bench_now ();
+      while (n < counts[k])
+	fp[n++] = funopen (NULL, source, NULL, NULL, NULL);
+      topen = bench_now () - topen;
+
+      BENCH_BEST (t, RUNS, CHURN,
+		  (j = rand () % n,
+		   fclose (fp[j]),
+		   fp[j] = funopen (NULL, source, NULL, NULL, NULL)));
+
+      printf ("%8d%8d", n, nglue ());
+      bench_print (16, topen, n - start);
+      bench_print (16, t, CHURN);
+      printf ("\n");
+    }
+  printf ("(" BENCH_UNIT " per call)\n");
+  return 0;
+}
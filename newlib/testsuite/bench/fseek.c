@@ -0,0 +1,109 @@
+/* Count the reads and seeks that stdio asks of the system, and time
+   each operation, for seek-heavy ways of reading a 1MB file.  Compare
+   a default build with one configured with
+   --enable-newlib-nano-fseek-optimization.
+
+   The counting wraps _read_r and _lseek_r, so link with
+	-Wl,--wrap=_read_r,--wrap=_lseek_r
+   On a target built with REENTRANT_SYSCALLS_PROVIDED and
+   MISSING_SYSCALL_NAMES, stdio calls read and lseek instead; wrap those
+   and change the names below.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <reent.h>
+#include "bench.h"
+
+#define SIZE (1024 * 1024L)
+#define NAME "fseek.tmp"
+
+static long nread, nseek;
+
+_ssize_t __real__read_r (struct _reent *, int, void *, size_t);
+_off_t __real__lseek_r (struct _reent *, int, _off_t, int);
+
+_ssize_t
+__wrap__read_r (struct _reent *ptr, int fd, void *buf, size_t n)
+{
+  nread++;
+  return __real__read_r (ptr, fd, buf, n);
+}
+
+_off_t
+__wrap__lseek_r (struct _reent *ptr, int fd, _off_t off, int whence)
+{
+  nseek++;
+  return __real__lseek_r (ptr, fd, off, whence);
+}
+
+static void
+report (const char *name, bench_t t, long ops)
+{
+  printf ("%-28s%8ld%8ld", name, nread, nseek);
+  bench_print (10, t, ops);
+  printf ("\n");
+}
+
+int
+main (void)
+{
+  char rec[32];
+  FILE *fp;
+  bench_t t;
+  long i, ops;
+
+  bench_init ();
+  fp = fopen (NAME, "w");
+  if (fp == NULL)
+    {
+      printf ("cannot create " NAME "\n");
+      return 1;
+    }
+  for (i = 0; i < SIZE; i++)
+    putc (i & 0xff, fp);
+  fclose (fp);
+  fp = fopen (NAME, "r");
+  printf ("%-28s%8s%8s%10s\n", "", "reads", "seeks", BENCH_UNIT);
+
+  /* A record reader reads a 16 byte header, steps back 8 bytes and
+     reads a 24 byte record.  */
+  nread = nseek = ops = 0;
+  t = bench_now ();
+  while (fread (rec, 1, 16, fp) == 16)
+    {
+      fseek (fp, -8, SEEK_CUR);
+      if (fread (rec, 1, 24, fp) != 24)
+	break;
+      ops += 2;
+    }
+  report ("read, SEEK_CUR -8, read", bench_now () - t, ops);
+
+  /* A tokenizer moves forward and backtracks 1 to 64 bytes.  */
+  rewind (fp);
+  nread = nseek = ops = 0;
+  t = bench_now ();
+  for (i = 0; i < SIZE - 200; i += 100)
+    {
+      fseek (fp, i, SEEK_SET);
+      fread (rec, 1, 32, fp);
+      fseek (fp, i + 1 + i % 64, SEEK_SET);
+      fread (rec, 1, 16, fp);
+      ops += 2;
+    }
+  report ("forward, backtrack 1-64", bench_now () - t, ops);
+
+  srand (1);
+  nread = nseek = ops = 0;
+  t = bench_now ();
+  for (i = 0; i < 20000; i++)
+    {
+      fseek (fp, rand () % (SIZE - 32), SEEK_SET);
+      fread (rec, 1, 32, fp);
+      ops++;
+    }
+  report ("random 32 byte reads", bench_now () - t, ops);
+
+  fclose (fp);
+  remove (NAME);
+  return 0;
+}
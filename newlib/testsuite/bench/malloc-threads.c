@@ -0,0 +1,257 @@
+/* Run a random trace of malloc and free calls in 1, 2, 4 and 8 threads
+   at once, and print the elapsed time per call.  Each thread has its
+   own struct _reent and calls _malloc_r and _free_r with it.  One freed
+   block in sixteen is handed to the next thread to be freed there, so
+   chunks move between thread caches.
+
+   This is also a stress test: every block is filled with a pattern that
+   is checked when it is freed, and once all threads are gone mallinfo
+   must show the same space in use as before they started.  The program
+   prints FAILED and exits with 1 if either check fails.
+
+   Compare builds configured with --enable-newlib-nano-malloc-lock and
+   with --enable-newlib-nano-malloc-tcache.  The program needs pthreads
+   from the target, and supplies __malloc_lock and __malloc_unlock
+   itself, so that the malloc lock is a real one.  Where bench.h falls
+   back to clock (), the times are CPU time summed over the threads.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <reent.h>
+#include <newlib.h>
+#include "bench.h"
+
+#ifndef _NANO_MALLOC_LOCK
+#ifndef _NANO_MALLOC_TCACHE
+#error "needs a newlib configured with --enable-newlib-nano-malloc-lock"
+#endif
+#endif
+
+#define MAXTHREADS 8
+#define SLOTS 256
+#define OPS 1000000L
+#define MBOX 64
+
+struct worker
+{
+  struct _reent reent;
+  pthread_t id;
+  unsigned long seed;
+  void *slot[SLOTS];
+  /* Blocks handed over by the previous thread, guarded by lock.  */
+  pthread_mutex_t lock;
+  void *mbox[MBOX];
+  int nmbox;
+  int bad;
+};
+
+static struct worker workers[MAXTHREADS];
+static int nthreads;
+static int running;
+static pthread_mutex_t running_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The malloc lock.  Nano malloc does not take it recursively, but the
+   lock newlib provides is recursive, so this one is too.  */
+static pthread_mutex_t malloc_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t malloc_owner;
+static int malloc_depth;
+
+void
+__malloc_lock (struct _reent *ptr)
+{
+  if (malloc_depth != 0 && pthread_equal (malloc_owner, pthread_self ()))
+    {
+      malloc_depth++;
+      return;
+    }
+  pthread_mutex_lock (&malloc_mutex);
+  malloc_owner = pthread_self ();
+  malloc_depth = 1;
+}
+
+void
+__malloc_unlock (struct _reent *ptr)
+{
+  if (--malloc_depth == 0)
+    pthread_mutex_unlock (&malloc_mutex);
+}
+
+static unsigned long
+rnd (struct worker *w)
+{
+  w->seed = w->seed * 1103515245 + 12345;
+  return (w->seed >> 16) & 0x7fff;
+}
+
+/* A block of N bytes keeps N in its first bytes, and a byte derived from
+   N in the rest.  */
+static void *
+get (struct worker *w, size_t n)
+{
+  unsigned char *p = _malloc_r (&w->reent, n);
+
+  if (p == NULL)
+    {
+      w->bad = 1;
+      return NULL;
+    }
+  memcpy (p, &n, sizeof (n));
+  memset (p + sizeof (n), (unsigned char) (n ^ 0x5a), n - sizeof (n));
+  return p;
+}
+
+static void
+put (struct worker *w, unsigned char *p)
+{
+  size_t i, n;
+
+  memcpy (&n, p, sizeof (n));
+  for (i = sizeof (n); i < n; i++)
+    if (p[i] != (unsigned char) (n ^ 0x5a))
+      {
+	w->bad = 1;
+	break;
+      }
+  _free_r (&w->reent, p);
+}
+
+static void
+drain (struct worker *w)
+{
+  void *held[MBOX];
+  int i, n;
+
+  pthread_mutex_lock (&w->lock);
+  n = w->nmbox;
+  memcpy (held, w->mbox, n * sizeof (held[0]));
+  w->nmbox = 0;
+  pthread_mutex_unlock (&w->lock);
+  for (i = 0; i < n; i++)
+    put (w, held[i]);
+}
+
+/* Hand P to the next thread, or free it here if its box is full.  */
+static void
+pass (struct worker *w, void *p)
+{
+  struct worker *next = &workers[(w - workers + 1) % nthreads];
+
+  pthread_mutex_lock (&next->lock);
+  if (next->nmbox < MBOX)
+    {
+      next->mbox[next->nmbox++] = p;
+      p = NULL;
+    }
+  pthread_mutex_unlock (&next->lock);
+  if (p != NULL)
+    put (w, p);
+}
+
+static void *
+run (void *arg)
+{
+  struct worker *w = arg;
+  unsigned long r;
+  long k;
+  int i, more;
+
+  for (k = 0; k < OPS; k++)
+    {
+      i = rnd (w) % SLOTS;
+      if (w->slot[i] != NULL)
+	{
+	  if (nthreads > 1 && k % 16 == 0)
+	    pass (w, w->slot[i]);
+	  else
+	    put (w, w->slot[i]);
+	  w->slot[i] = NULL;
+	}
+      else
+	{
+	  r = rnd (w);
+	  w->slot[i] = get (w, r % 8 == 0 ? 64 + r % 960 : 16 + r % 48);
+	}
+      if (k % 64 == 0)
+	drain (w);
+    }
+  for (i = 0; i < SLOTS; i++)
+    if (w->slot[i] != NULL)
+      {
+	put (w, w->slot[i]);
+	w->slot[i] = NULL;
+      }
+
+  /* Others may still pass blocks here until they are all done.  */
+  pthread_mutex_lock (&running_lock);
+  running--;
+  pthread_mutex_unlock (&running_lock);
+  do
+    {
+      pthread_mutex_lock (&running_lock);
+      more = running != 0;
+      pthread_mutex_unlock (&running_lock);
+      drain (w);
+    }
+  while (more);
+
+  _reclaim_reent (&w->reent);
+  return NULL;
+}
+
+int
+main (void)
+{
+  static const int counts[] = { 1, 2, 4, MAXTHREADS };
+  struct mallinfo before, after;
+  bench_t t;
+  int i, k, failed = 0;
+
+  bench_init ();
+  printf ("%8s%16s%16s\n", "threads", "per call", "per thread call");
+  for (k = 0; k < (int) (sizeof (counts) / sizeof (counts[0])); k++)
+    {
+      nthreads = running = counts[k];
+      before = mallinfo ();
+      t = bench_now ();
+      for (i = 0; i < nthreads; i++)
+	{
+	  struct worker *w = &workers[i];
+
+	  memset (w, 0, sizeof (*w));
+	  _REENT_INIT_PTR (&w->reent);
+	  pthread_mutex_init (&w->lock, NULL);
+	  w->seed = i + 1;
+	  if (pthread_create (&w->id, NULL, run, w) != 0)
+	    {
+	      printf ("cannot create thread %d\n", i);
+	      return 1;
+	    }
+	}
+      for (i = 0; i < nthreads; i++)
+	{
+	  pthread_join (workers[i].id, NULL);
+	  pthread_mutex_destroy (&workers[i].lock);
+	  if (workers[i].bad)
+	    failed = 1;
+	}
+      t = bench_now () - t;
+      after = mallinfo ();
+      if (after.uordblks != before.uordblks)
+	failed = 1;
+
+      printf ("%8d", nthreads);
+      bench_print (16, t, OPS * nthreads);
+      bench_print (16, t, OPS);
+      printf ("\n");
+    }
+  printf ("(" BENCH_UNIT " per malloc or free)\n");
+  if (failed)
+    {
+      printf ("FAILED\n");
+      return 1;
+    }
+  return 0;
+}
@@ -0,0 +1,68 @@
+/* Replay a random trace of malloc and free calls over SLOTS live
+   blocks, mostly small with one in eight between 256 and 2303 bytes,
+   and print the time per call, the heap taken from sbrk and how much
+   of it the live blocks used at their peak.
+
+   Compare a default build with one configured with
+   --enable-newlib-nano-malloc-bins.  */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include "bench.h"
+
+#define SLOTS 4096
+#define OPS 2000000L
+
+static void *slot[SLOTS];
+static size_t size[SLOTS];
+static unsigned long seed = 1;
+
+/* The trace must not depend on the rand of the library under test.  */
+static unsigned long
+rnd (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+int
+main (void)
+{
+  char *base;
+  unsigned long r, live, peak, heap;
+  bench_t t;
+  long k;
+  int i;
+
+  bench_init ();
+  base = sbrk (0);
+  live = peak = 0;
+  t = bench_now ();
+  for (k = 0; k < OPS; k++)
+    {
+      i = rnd () % SLOTS;
+      if (slot[i] != NULL)
+	{
+	  free (slot[i]);
+	  slot[i] = NULL;
+	  live -= size[i];
+	}
+      else
+	{
+	  r = rnd ();
+	  size[i] = r % 8 == 0 ? 256 + r % 2048 : 1 + r % 100;
+	  slot[i] = malloc (size[i]);
+	  live += size[i];
+	  if (live > peak)
+	    peak = live;
+	}
+    }
+  t = bench_now () - t;
+  heap = (char *) sbrk (0) - base;
+
+  printf ("%ld calls, " BENCH_UNIT " per call:", OPS);
+  bench_print (8, t, OPS);
+  printf ("\nheap %lu bytes, peak live %lu bytes (%lu%%)\n",
+	  heap, peak, peak * 100 / heap);
+  return 0;
+}
@@ -0,0 +1,65 @@
+/* Time memmove, memcmp, memchr and memset on blocks of 8 to 4096
+   bytes, and print the time per call.  memmove+1 moves a block one byte
+   up within a buffer, so it has to copy from the end, and memmove-1
+   moves it one byte down.  memcmp compares equal blocks and memchr
+   looks for a byte that is not there, so every call reads the whole
+   block.  */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+
+#define MAXLEN 4096
+#define RUNS 5
+
+static char a[MAXLEN + 128] __attribute__ ((aligned (64)));
+static char b[MAXLEN + 128] __attribute__ ((aligned (64)));
+static volatile size_t sink;
+
+static const int lens[] = { 8, 32, 128, 512, 4096 };
+static const char *const names[] =
+{
+  "memmove+1", "memmove-1", "memcmp", "memchr", "memset"
+};
+
+#define NLENS ((int) (sizeof (lens) / sizeof (lens[0])))
+#define NFUNCS ((int) (sizeof (names) / sizeof (names[0])))
+
+int
+main (void)
+{
+  bench_t best;
+  size_t len;
+  long n;
+  int f, i;
+
+  bench_init ();
+  printf ("%-12s", BENCH_UNIT);
+  for (i = 0; i < NLENS; i++)
+    printf ("%8d", lens[i]);
+  printf ("\n");
+  for (f = 0; f < NFUNCS; f++)
+    {
+      printf ("%-12s", names[f]);
+      for (i = 0; i < NLENS; i++)
+	{
+	  memset (a, 'a', sizeof (a));
+	  memset (b, 'a', sizeof (b));
+	  len = lens[i];
+	  n = 2000000 / (1 + lens[i] / 64);
+	  if (f == 0)
+	    BENCH_BEST (best, RUNS, n, memmove (a + 1, a, len));
+	  else if (f == 1)
+	    BENCH_BEST (best, RUNS, n, memmove (a, a + 1, len));
+	  else if (f == 2)
+	    BENCH_BEST (best, RUNS, n, sink = memcmp (a, b, len));
+	  else if (f == 3)
+	    BENCH_BEST (best, RUNS, n, sink = (size_t) memchr (a, 'b', len));
+	  else
+	    BENCH_BEST (best, RUNS, n, memset (a, 0, len));
+	  bench_print (8, best, n);
+	}
+      printf ("\n");
+    }
+  return 0;
+}
@@ -0,0 +1,82 @@
+/* Time memcpy from 1 byte to 64MB followed by reading one byte of each
+   64 byte line of the copy, as a caller would, and print the time per
+   copy and read.  Sizes that malloc cannot provide twice are skipped;
+   -DMAXSIZE=n lowers the largest size.
+
+   On x86_64, -DNT_THRESHOLD=n sets the size from which memcpy uses
+   non-temporal stores, instead of the one taken from the cache size.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#ifndef MAXSIZE
+#define MAXSIZE (64L << 20)
+#endif
+#define RUNS 3
+
+#if defined (__x86_64__) && defined (NT_THRESHOLD)
+extern long __x86_64_nt_threshold;
+#endif
+
+static volatile long sink;
+
+/* Copy N bytes from SRC to DST, then read the copy.  */
+static void
+copy_read (char *dst, const char *src, long n)
+{
+  long i, s = 0;
+
+  memcpy (dst, src, n);
+  for (i = 0; i < n; i += 64)
+    s += dst[i];
+  sink = s;
+}
+
+int
+main (void)
+{
+  char *src, *dst;
+  long n, reps;
+  bench_t best;
+
+  bench_init ();
+#if defined (__x86_64__) && defined (NT_THRESHOLD)
+  {
+    /* The first call sets the threshold from the cache size.  */
+    static char c1[300], c2[300];
+    volatile size_t z = sizeof (c1);
+
+    memcpy (c1, c2, z);
+    __x86_64_nt_threshold = NT_THRESHOLD;
+  }
+#endif
+  printf ("%10s%16s\n", "size", BENCH_UNIT);
+  for (n = 1; n <= MAXSIZE; n *= n < 32 ? 32 : 2)
+    {
+      src = malloc (n + 64);
+      dst = malloc (n + 64);
+      if (src == NULL || dst == NULL)
+	{
+	  printf ("%10ld%16s\n", n, "no memory");
+	  free (src);
+	  free (dst);
+	  continue;
+	}
+      memset (src, 1, n);
+      memset (dst, 2, n);
+      reps = (256L << 20) / n;
+      if (reps > 1000000)
+	reps = 1000000;
+      if (reps < 4)
+	reps = 4;
+      BENCH_BEST (best, RUNS, reps, copy_read (dst, src, n));
+      printf ("%10ld", n);
+      bench_print (16, best, reps);
+      printf ("\n");
+      free (src);
+      free (dst);
+    }
+  return 0;
+}
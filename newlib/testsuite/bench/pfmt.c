@@ -0,0 +1,80 @@
+/* Time snprintf and fprintf against snprintf_pfmt and fprintf_pfmt on
+   the same formats, compiled once with pfmt_compile, and the compiling
+   itself.  fprintf writes through funopen to a sink that does nothing.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+
+#define N 2000
+#define RUNS 31
+
+#define LOG "[%s] %s:%d: connection from %s accepted, fd=%d\n"
+#define LOG_ARGS "INFO", "server.c", i, "192.168.1.100", 7
+#define TABLE "%-12s|%8d|%08x|%20s|\n"
+#define TABLE_ARGS "sensor", i, i * 77, "temperature ok"
+#define MANY "%5s %-10s %6lu %6lu %+8ld %#10lx %c%c\n"
+#define MANY_ARGS "ab", "cdef", (unsigned long) i, 42ul, -7l, 0xfful, 'x', 'y'
+
+static char buf[256];
+
+static int
+sink (void *cookie, const char *p, int n)
+{
+  return n;
+}
+
+static void
+compile (pfmt_t *pf, int n, const char *format)
+{
+  int r = pfmt_compile (pf, n, format);
+
+  if (r < 0 || r > n)
+    {
+      printf ("pfmt_compile (\"%s\") returned %d\n", format, r);
+      exit (1);
+    }
+}
+
+#define ROW(name, stmt)				\
+  do						\
+    {						\
+      BENCH_BEST (t, RUNS, N, (stmt, i++));	\
+      printf ("%-24s", name);			\
+      bench_print (8, t, N);			\
+      printf ("\n");				\
+    }						\
+  while (0)
+
+int
+main (void)
+{
+  pfmt_t pf_log[8], pf_table[8], pf_many[10];
+  FILE *fp;
+  bench_t t;
+  int i = 0;
+
+  bench_init ();
+  fp = funopen (NULL, NULL, sink, NULL, NULL);
+  compile (pf_log, 8, LOG);
+  compile (pf_table, 8, TABLE);
+  compile (pf_many, 10, MANY);
+
+  printf (BENCH_UNIT " per call\n");
+  ROW ("snprintf      log line", snprintf (buf, sizeof (buf), LOG, LOG_ARGS));
+  ROW ("snprintf_pfmt log line",
+       snprintf_pfmt (buf, sizeof (buf), pf_log, LOG_ARGS));
+  ROW ("snprintf      table row",
+       snprintf (buf, sizeof (buf), TABLE, TABLE_ARGS));
+  ROW ("snprintf_pfmt table row",
+       snprintf_pfmt (buf, sizeof (buf), pf_table, TABLE_ARGS));
+  ROW ("snprintf      8 conv.", snprintf (buf, sizeof (buf), MANY, MANY_ARGS));
+  ROW ("snprintf_pfmt 8 conv.",
+       snprintf_pfmt (buf, sizeof (buf), pf_many, MANY_ARGS));
+  ROW ("fprintf       log line", fprintf (fp, LOG, LOG_ARGS));
+  ROW ("fprintf_pfmt  log line", fprintf_pfmt (fp, pf_log, LOG_ARGS));
+  ROW ("fprintf       8 conv.", fprintf (fp, MANY, MANY_ARGS));
+  ROW ("fprintf_pfmt  8 conv.", fprintf_pfmt (fp, pf_many, MANY_ARGS));
+  ROW ("pfmt_compile  8 conv.", pfmt_compile (pf_many, 10, MANY));
+  return 0;
+}
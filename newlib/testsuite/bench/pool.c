@@ -0,0 +1,114 @@
+/* Free and reallocate random objects among N live 24 byte objects,
+   first with malloc and free and then with a malloc_pool, and print the
+   time per pair.  Then time a tsearch and tdelete pair on an empty tree
+   and on a tree of N keys.  tsearch takes its nodes from a pool.  */
+
+#include <stdlib.h>
+#include <malloc.h>
+#include <search.h>
+#include "bench.h"
+
+#define N 256
+#define PAIRS 2000000L
+#define RUNS 5
+
+static void *obj[N];
+static void *root, *empty;
+static long keys[2 * N];
+static unsigned long seed;
+
+static unsigned long
+rnd (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+static int
+cmp (const void *a, const void *b)
+{
+  long x = *(const long *) a, y = *(const long *) b;
+
+  return x < y ? -1 : x > y;
+}
+
+static void
+churn_malloc (void)
+{
+  int i = rnd () % N;
+
+  free (obj[i]);
+  obj[i] = malloc (24);
+}
+
+static void
+churn_pool (struct malloc_pool *pool)
+{
+  int i = rnd () % N;
+
+  malloc_pool_free (pool, obj[i]);
+  obj[i] = malloc_pool_alloc (pool);
+}
+
+/* Keys below N stay in the tree; one of N to 2N-1 comes and goes.  */
+static void
+churn_tree (void)
+{
+  long *k = &keys[N + rnd () % N];
+
+  tsearch (k, &root, cmp);
+  tdelete (k, &root, cmp);
+}
+
+/* A tree that goes from empty to one node and back.  */
+static void
+churn_empty (void)
+{
+  tsearch (&keys[0], &empty, cmp);
+  tdelete (&keys[0], &empty, cmp);
+}
+
+int
+main (void)
+{
+  struct malloc_pool pool;
+  bench_t t;
+  int i;
+
+  bench_init ();
+  seed = 1;
+  for (i = 0; i < N; i++)
+    obj[i] = malloc (24);
+  BENCH_BEST (t, RUNS, PAIRS, churn_malloc ());
+  printf ("malloc and free     ");
+  bench_print (8, t, PAIRS);
+  printf (" " BENCH_UNIT " per pair\n");
+  for (i = 0; i < N; i++)
+    free (obj[i]);
+
+  malloc_pool_init (&pool, 24, NULL, 64);
+  for (i = 0; i < N; i++)
+    obj[i] = malloc_pool_alloc (&pool);
+  BENCH_BEST (t, RUNS, PAIRS, churn_pool (&pool));
+  printf ("pool alloc and free ");
+  bench_print (8, t, PAIRS);
+  printf (" " BENCH_UNIT " per pair\n");
+  malloc_pool_destroy (&pool);
+
+  /* No other tree holds a node yet.  */
+  for (i = 0; i < 2 * N; i++)
+    keys[i] = i;
+  BENCH_BEST (t, RUNS, PAIRS, churn_empty ());
+  printf ("tsearch and tdelete ");
+  bench_print (8, t, PAIRS);
+  printf (" " BENCH_UNIT " per pair, empty tree\n");
+
+  /* The tree is not balanced, so insert the keys in random order.  */
+  for (i = 0; i < N; i++)
+    tsearch (&keys[rnd () % N], &root, cmp);
+  BENCH_BEST (t, RUNS, PAIRS, churn_tree ());
+  printf ("tsearch and tdelete ");
+  bench_print (8, t, PAIRS);
+  printf (" " BENCH_UNIT " per pair, %d keys\n", N);
+  return 0;
+}
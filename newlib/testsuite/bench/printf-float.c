@@ -0,0 +1,43 @@
+/* Time sprintf on floating point conversions of doubles in
+   [-1000, 1000] with up to 9 decimals, and print the time per call.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+asm (".global _printf_float");
+
+#define N 1024
+#define RUNS 6
+
+static double val[N];
+static char buf[128];
+
+static const char *const fmts[] =
+{
+  "%f", "%.2f", "%.3f", "%e", "%g", "%.10g", "%.17g"
+};
+
+int
+main (void)
+{
+  unsigned int x = 12345;
+  bench_t t;
+  int i, k;
+
+  bench_init ();
+  for (i = 0; i < N; i++)
+    {
+      x = x * 1103515245 + 12345;
+      val[i] = (double) (x % 2000000001) / 1e6 - 1000;
+    }
+  printf ("sprintf, " BENCH_UNIT " per call\n");
+  for (k = 0; k < (int) (sizeof (fmts) / sizeof (fmts[0])); k++)
+    {
+      i = 0;
+      BENCH_BEST (t, RUNS, N, sprintf (buf, fmts[k], val[i++ % N]));
+      printf ("%-8s", fmts[k]);
+      bench_print (8, t, N);
+      printf ("\n");
+    }
+  return 0;
+}
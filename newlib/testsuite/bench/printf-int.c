@@ -0,0 +1,52 @@
+/* Time sprintf on integer conversions, with values spread over their
+   whole range, and print the time per call.  The %llu and %zu rows
+   print the same values as %lu.  */
+
+#include <stdio.h>
+#include <stddef.h>
+#include "bench.h"
+
+asm (".global _printf_c99");
+
+#define N 1024
+#define RUNS 6
+
+static unsigned int val[N];
+static char buf[128];
+
+/* Time N calls of sprintf (buf, FMT, ARGS...), with I the index into
+   val.  */
+#define ROW(fmt, args)					\
+  do							\
+    {							\
+      unsigned int i = 0;				\
+							\
+      BENCH_BEST (t, RUNS, N, (sprintf args, i++));	\
+      printf ("%-24s", fmt);				\
+      bench_print (8, t, N);				\
+      printf ("\n");					\
+    }							\
+  while (0)
+
+int
+main (void)
+{
+  bench_t t;
+  int i;
+
+  bench_init ();
+  for (i = 0; i < N; i++)
+    val[i] = (i + 1) * 2654435761u;
+  printf ("sprintf, " BENCH_UNIT " per call\n");
+  ROW ("\"%d\"", (buf, "%d", (int) val[i % N]));
+  ROW ("\"%lu\"", (buf, "%lu", (unsigned long) val[i % N] * val[i % N]));
+  ROW ("\"%llu\"", (buf, "%llu",
+		    (unsigned long long) val[i % N] * val[i % N]));
+  ROW ("\"%zu\"", (buf, "%zu", (size_t) val[i % N] * val[i % N]));
+  ROW ("\"%x\"", (buf, "%x", val[i % N]));
+  ROW ("\"%o\"", (buf, "%o", val[i % N]));
+  ROW ("\"%5.3d\"", (buf, "%5.3d", (int) (val[i % N] % 100000)));
+  ROW ("\"id=%u val=%08x %s %d\"",
+       (buf, "id=%u val=%08x %s %d", i, val[i % N], "name", -(int) i));
+  return 0;
+}
@@ -0,0 +1,61 @@
+/* Time sprintf, snprintf and fprintf on typical log and table lines,
+   and print the time per call.  fprintf writes through funopen to a
+   sink that does nothing, fully buffered, line buffered or unbuffered,
+   so that no system call is timed.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+#define N 2000
+#define RUNS 31
+
+#define LOG "[%s] %s:%d: connection from %s accepted, fd=%d\n", \
+	    "INFO", "server.c", i, "192.168.1.100", 7
+#define TABLE "%-12s|%8d|%08x|%20s|\n", \
+	      "sensor", i, i * 77, "temperature ok"
+#define LITERAL "tick %u: all systems nominal, nothing to report\n", i
+
+static char buf[256];
+
+static int
+sink (void *cookie, const char *p, int n)
+{
+  return n;
+}
+
+#define ROW(name, stmt)				\
+  do						\
+    {						\
+      BENCH_BEST (t, RUNS, N, (stmt, i++));	\
+      printf ("%-24s", name);			\
+      bench_print (8, t, N);			\
+      printf ("\n");				\
+    }						\
+  while (0)
+
+int
+main (void)
+{
+  FILE *full, *line, *none;
+  bench_t t;
+  int i = 0;
+
+  bench_init ();
+  full = funopen (NULL, NULL, sink, NULL, NULL);
+  line = funopen (NULL, NULL, sink, NULL, NULL);
+  none = funopen (NULL, NULL, sink, NULL, NULL);
+  setvbuf (line, NULL, _IOLBF, 256);
+  setvbuf (none, NULL, _IONBF, 0);
+
+  printf (BENCH_UNIT " per call\n");
+  ROW ("sprintf  log line", sprintf (buf, LOG));
+  ROW ("sprintf  table row", sprintf (buf, TABLE));
+  ROW ("sprintf  literal", sprintf (buf, LITERAL));
+  ROW ("snprintf log line", snprintf (buf, 40, LOG));
+  ROW ("fprintf  log line", fprintf (full, LOG));
+  ROW ("fprintf  table row", fprintf (full, TABLE));
+  ROW ("fprintf  literal", fprintf (full, LITERAL));
+  ROW ("fprintf  line buffered", fprintf (line, LOG));
+  ROW ("fprintf  unbuffered", fprintf (none, LOG));
+  return 0;
+}
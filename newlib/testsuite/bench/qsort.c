@@ -0,0 +1,152 @@
+/* Time qsort on N elements of 4 and 16 bytes in random, sorted,
+   reversed, organ pipe and all equal order, and against McIlroy's
+   adversary, and print the time and the number of comparator calls.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#define N 100000
+#define RUNS 5
+
+struct elt16
+{
+  long key;
+  long pad[16 / sizeof (long) - 1];
+};
+
+static unsigned long ncmp;
+
+static int
+cmp4 (const void *a, const void *b)
+{
+  int x = *(const int *) a, y = *(const int *) b;
+
+  ncmp++;
+  return x < y ? -1 : x > y;
+}
+
+static int
+cmp16 (const void *a, const void *b)
+{
+  long x = ((const struct elt16 *) a)->key;
+  long y = ((const struct elt16 *) b)->key;
+
+  ncmp++;
+  return x < y ? -1 : x > y;
+}
+
+static long
+key (int pattern, long i)
+{
+  switch (pattern)
+    {
+    case 0:
+      return rand ();
+    case 1:
+      return i;
+    case 2:
+      return N - i;
+    case 3:
+      return i < N / 2 ? i : N - i;
+    default:
+      return 42;
+    }
+}
+
+static int *val;
+static int gas, nsolid, candidate;
+
+/* From "A Killer Adversary for Quicksort", M. D. McIlroy, 1999.  */
+static int
+adversary (const void *px, const void *py)
+{
+  int x = *(const int *) px, y = *(const int *) py;
+
+  ncmp++;
+  if (val[x] == gas && val[y] == gas)
+    val[x == candidate ? x : y] = nsolid++;
+  if (val[x] == gas)
+    candidate = x;
+  else if (val[y] == gas)
+    candidate = y;
+  return val[x] - val[y];
+}
+
+static void
+report (const char *name, bench_t t, unsigned long calls)
+{
+  printf ("%-24s", name);
+  bench_print (14, t, 1000);
+  printf ("%14lu\n", calls / 1000);
+}
+
+int
+main (void)
+{
+  static const char *const names[] =
+  {
+    "random", "sorted", "reversed", "organ pipe", "all equal"
+  };
+  char label[32];
+  void *src, *arr;
+  size_t es;
+  unsigned long calls = 0;
+  bench_t t, best;
+  int pattern, r;
+  long i;
+
+  bench_init ();
+  src = malloc (N * sizeof (struct elt16));
+  arr = malloc (N * sizeof (struct elt16));
+  val = malloc (N * sizeof (int));
+  if (src == NULL || arr == NULL || val == NULL)
+    {
+      printf ("no memory\n");
+      return 1;
+    }
+  sprintf (label, "n = %d", N);
+  printf ("%-24s%14s%14s\n", label, "K" BENCH_UNIT, "K calls");
+  for (es = sizeof (int); es <= sizeof (struct elt16); es *= 4)
+    for (pattern = 0; pattern < 5; pattern++)
+      {
+	srand (1);
+	memset (src, 0, N * es);
+	for (i = 0; i < N; i++)
+	  if (es == sizeof (int))
+	    ((int *) src)[i] = key (pattern, i);
+	  else
+	    ((struct elt16 *) src)[i].key = key (pattern, i);
+	best = (bench_t) -1;
+	for (r = 0; r < RUNS; r++)
+	  {
+	    memcpy (arr, src, N * es);
+	    ncmp = 0;
+	    t = bench_now ();
+	    qsort (arr, N, es, es == sizeof (int) ? cmp4 : cmp16);
+	    t = bench_now () - t;
+	    if (t < best)
+	      {
+		best = t;
+		calls = ncmp;
+	      }
+	  }
+	sprintf (label, "%d byte, %s", (int) es, names[pattern]);
+	report (label, best, calls);
+      }
+
+  gas = N - 1;
+  nsolid = 0;
+  for (i = 0; i < N; i++)
+    {
+      ((int *) arr)[i] = i;
+      val[i] = gas;
+    }
+  ncmp = 0;
+  t = bench_now ();
+  qsort (arr, N, sizeof (int), adversary);
+  t = bench_now () - t;
+  report ("McIlroy adversary", t, ncmp);
+  return 0;
+}
@@ -0,0 +1,71 @@
+/* Grow buffers by doubling from 16 bytes to 64KB with realloc, one
+   buffer alone and then several in turn with small blocks allocated
+   between them, and print how many of the old bytes realloc copied
+   and the time per call.  Before realloc grew blocks in place, every
+   old byte was copied.  */
+
+#include <stdlib.h>
+#include "bench.h"
+
+#define MAXV 4
+#define STEPS 12
+
+static void
+grow (int nv)
+{
+  char *v[MAXV], *q;
+  void *junk[MAXV * STEPS];
+  size_t size[MAXV];
+  unsigned long old, copied;
+  int i, k, nj;
+  bench_t t;
+
+  for (k = 0; k < nv; k++)
+    {
+      v[k] = malloc (16);
+      size[k] = 16;
+    }
+  old = copied = 0;
+  nj = 0;
+  t = bench_now ();
+  for (i = 0; i < STEPS; i++)
+    for (k = 0; k < nv; k++)
+      {
+	q = realloc (v[k], size[k] * 2);
+	old += size[k];
+	if (q != v[k])
+	  copied += size[k];
+	v[k] = q;
+	size[k] *= 2;
+	/* Something else allocates meanwhile, and keeps half of it.  */
+	if (nv > 1)
+	  {
+	    junk[nj] = malloc (24);
+	    if (k & 1)
+	      free (junk[nj]);
+	    else
+	      nj++;
+	  }
+      }
+  t = bench_now () - t;
+
+  printf ("%d buffer%s  %7lu of %7lu bytes copied, " BENCH_UNIT
+	  " per call:", nv, nv == 1 ? " " : "s", copied, old);
+  bench_print (9, t, (long) nv * STEPS);
+  printf ("\n");
+
+  for (k = 0; k < nv; k++)
+    free (v[k]);
+  while (nj > 0)
+    free (junk[--nj]);
+}
+
+int
+main (void)
+{
+  bench_init ();
+  grow (1);
+  grow (2);
+  grow (4);
+  return 0;
+}
@@ -0,0 +1,57 @@
+/* Time getc on an unbuffered stream, which refills on every call,
+   with more and more other streams open, and print the time per call.
+   The first ten of the other streams are line buffered and the rest
+   fully buffered.  All of them are made with funopen, so no system call
+   is timed.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+#define N 20000
+#define RUNS 5
+#define MAXOPEN 1000
+
+static FILE *other[MAXOPEN];
+
+static int
+source (void *cookie, char *p, int n)
+{
+  *p = 'x';
+  return 1;
+}
+
+static int
+sink (void *cookie, const char *p, int n)
+{
+  return n;
+}
+
+int
+main (void)
+{
+  static const int counts[] = { 0, 10, 100, 500, 1000 };
+  int k, nopen = 0;
+  FILE *in;
+  bench_t t;
+
+  bench_init ();
+  in = funopen (NULL, source, NULL, NULL, NULL);
+  setvbuf (in, NULL, _IONBF, 0);
+  printf ("%-12s%12s\n", "open FILEs", BENCH_UNIT);
+  for (k = 0; k < (int) (sizeof (counts) / sizeof (counts[0])); k++)
+    {
+      while (nopen < counts[k])
+	{
+	  other[nopen] = funopen (NULL, NULL, sink, NULL, NULL);
+	  if (nopen < 10)
+	    setvbuf (other[nopen], NULL, _IOLBF, 256);
+	  fputs ("started\n", other[nopen]);
+	  nopen++;
+	}
+      BENCH_BEST (t, RUNS, N, getc (in));
+      printf ("%-12d", nopen + 4);
+      bench_print (12, t, N);
+      printf ("\n");
+    }
+  return 0;
+}
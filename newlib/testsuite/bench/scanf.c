@@ -0,0 +1,78 @@
+/* Time sscanf on a CSV line, a configuration line, long integers and
+   an address, and fscanf reading a file of N lines through fmemopen,
+   and print the time per call.  */
+
+#include <stdio.h>
+#include "bench.h"
+
+#define N 2000
+#define RUNS 31
+
+static char file[N * 40];
+static size_t len;
+
+#define ROW(name, stmt)				\
+  do						\
+    {						\
+      BENCH_BEST (t, RUNS, N, stmt);		\
+      printf ("%-40s", name);			\
+      bench_print (8, t, N);			\
+      printf ("\n");				\
+    }						\
+  while (0)
+
+/* Return the time fscanf takes to read the N lines of file.  */
+static bench_t
+scan_file (void)
+{
+  char s[32];
+  FILE *fp;
+  bench_t t;
+  int a, b;
+
+  fp = fmemopen (file, len, "r");
+  t = bench_now ();
+  while (fscanf (fp, "%d %d %s", &a, &b, s) == 3)
+    ;
+  t = bench_now () - t;
+  fclose (fp);
+  return t;
+}
+
+int
+main (void)
+{
+  char s1[32], s2[32], *p;
+  int a, b, c, d, i, r;
+  unsigned int u;
+  unsigned long ul, ux;
+  long l;
+  bench_t t, best;
+
+  bench_init ();
+  printf (BENCH_UNIT " per call\n");
+  ROW ("sscanf CSV line (%d,%d,%i,%u,%[^,],%s)",
+       sscanf ("1042,-77,0x1f,3141592,alpha,beta", "%d,%d,%i,%u,%[^,],%s",
+	       &a, &b, &c, &u, s1, s2));
+  ROW ("sscanf \"key = value\"",
+       sscanf ("  window_width = 1920", "%s = %d", s1, &a));
+  ROW ("sscanf %lu %lx %ld",
+       sscanf ("4000000000 deadbeef -123456789", "%lu %lx %ld",
+	       &ul, &ux, &l));
+  ROW ("sscanf address and port",
+       sscanf ("192.168.100.254:8080", "%d.%d.%d.%d:%u",
+	       &a, &b, &c, &d, &u));
+
+  p = file;
+  for (i = 0; i < N; i++)
+    p += sprintf (p, "%d %d item%d\n", i * 37, -i, i);
+  len = p - file;
+  best = (bench_t) -1;
+  for (r = 0; r < RUNS; r++)
+    if ((t = scan_file ()) < best)
+      best = t;
+  printf ("%-40s", "fscanf \"%d %d %s\" per line (fmemopen)");
+  bench_print (8, best, N);
+  printf ("\n");
+  return 0;
+}
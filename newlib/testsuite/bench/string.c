@@ -0,0 +1,62 @@
+/* Time strlen, strchr and strcmp on strings of 8 to 4096 bytes, with
+   the strings aligned and misaligned, and print the time per call.
+   strchr looks for a byte that is not there, and strcmp compares equal
+   strings, so every call reads the whole string.  In the misaligned
+   rows the string starts 5 bytes into a 64 byte line, and for strcmp
+   the two strings are misaligned differently.  */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+
+#define MAXLEN 4096
+#define RUNS 5
+
+static char a[MAXLEN + 128] __attribute__ ((aligned (64)));
+static char b[MAXLEN + 128] __attribute__ ((aligned (64)));
+static volatile size_t sink;
+
+static const int lens[] = { 8, 32, 128, 512, 4096 };
+static const char *const names[] = { "strlen", "strchr", "strcmp" };
+
+#define NLENS ((int) (sizeof (lens) / sizeof (lens[0])))
+
+int
+main (void)
+{
+  char *s, *t, label[16];
+  bench_t best;
+  long n;
+  int f, i, misalign;
+
+  bench_init ();
+  printf ("%-12s", BENCH_UNIT);
+  for (i = 0; i < NLENS; i++)
+    printf ("%8d", lens[i]);
+  printf ("\n");
+  for (f = 0; f < 3; f++)
+    for (misalign = 0; misalign <= 5; misalign += 5)
+      {
+	sprintf (label, "%s%s", names[f], misalign ? "+5" : "");
+	printf ("%-12s", label);
+	for (i = 0; i < NLENS; i++)
+	  {
+	    memset (a, 'a', sizeof (a));
+	    memset (b, 'a', sizeof (b));
+	    s = a + misalign;
+	    t = b + (misalign ? 3 : 0);
+	    s[lens[i]] = '\0';
+	    t[lens[i]] = '\0';
+	    n = 2000000 / (1 + lens[i] / 64);
+	    if (f == 0)
+	      BENCH_BEST (best, RUNS, n, sink = strlen (s));
+	    else if (f == 1)
+	      BENCH_BEST (best, RUNS, n, sink = (size_t) strchr (s, 'b'));
+	    else
+	      BENCH_BEST (best, RUNS, n, sink = strcmp (s, t));
+	    bench_print (8, best, n);
+	  }
+	printf ("\n");
+      }
+  return 0;
+}
@@ -0,0 +1,79 @@
+/* Time strstr, memmem and strcasestr for needles of 2 to 32 bytes in
+   haystacks of 64 bytes to 64KB, and print the time per call.  Most of
+   the needles do not occur, so the whole haystack is searched.  The
+   haystacks are:
+
+     text	lower case letters and spaces, searched for a word
+     rare	20 letters, searched for a needle of two others
+     aaaa	all 'a', searched for "aa...ab", the bad case for
+		naive searches  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#define MAXHAY 65536
+
+static char hay[MAXHAY + 1];
+static char needle[40];
+static volatile size_t haylen;
+static void *volatile sink;
+
+static const char *const types[] = { "text", "rare", "aaaa" };
+static const size_t haylens[] = { 64, 4096, MAXHAY };
+static const int needlelens[] = { 2, 3, 4, 6, 8, 12, 16, 32 };
+
+#define N(a) ((int) (sizeof (a) / sizeof ((a)[0])))
+
+static void
+make (int type, size_t hl, int nl)
+{
+  size_t i;
+  int r;
+
+  srand (2);
+  for (i = 0; i < hl; i++)
+    {
+      r = rand ();
+      hay[i] = type == 0 ? (r % 32 < 26 ? 'a' + r % 32 : ' ')
+	       : type == 1 ? 'a' + r % 20 : 'a';
+    }
+  hay[hl] = '\0';
+  haylen = hl;
+  for (i = 0; i < (size_t) nl; i++)
+    needle[i] = type == 0 ? 'a' + (i * 7) % 26
+		: type == 1 ? 'x' + i % 2 : 'a';
+  if (type == 2)
+    needle[nl - 1] = 'b';
+  needle[nl] = '\0';
+}
+
+int
+main (void)
+{
+  int type, h, k, nl, runs;
+  bench_t t;
+
+  bench_init ();
+  printf ("%-16s%6s%14s%14s%14s\n", "haystack", "needle",
+	  "strstr", "memmem", "strcasestr");
+  for (type = 0; type < N (types); type++)
+    for (h = 0; h < N (haylens); h++)
+      for (k = 0; k < N (needlelens); k++)
+	{
+	  nl = needlelens[k];
+	  make (type, haylens[h], nl);
+	  runs = haylens[h] > 4096 ? 20 : 200;
+	  printf ("%s %-11lu%6d", types[type], (unsigned long) haylens[h], nl);
+	  BENCH_BEST (t, runs, 1, sink = strstr (hay, needle));
+	  bench_print (14, t, 1);
+	  BENCH_BEST (t, runs, 1, sink = memmem (hay, haylen, needle, nl));
+	  bench_print (14, t, 1);
+	  BENCH_BEST (t, runs, 1, sink = strcasestr (hay, needle));
+	  bench_print (14, t, 1);
+	  printf ("\n");
+	}
+  printf ("(" BENCH_UNIT " per call)\n");
+  return 0;
+}
@@ -0,0 +1,165 @@
+/* Check that qsort and qsort_r sort arrays of various patterns and
+   element sizes, and that McIlroy's adversary, which makes a plain
+   quicksort quadratic, cannot push the number of comparisons above
+   a small multiple of n log2 n.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+#define MAXN 3000
+#define MAXES 24
+
+static unsigned char buf[MAXN * MAXES];
+static unsigned counts[256];
+static unsigned long ncmp;
+
+static const size_t sizes[] = { 1, 2, 4, 5, 8, 12, 16, 24 };
+
+/* The key of an element is its first byte; the other bytes repeat it,
+   so that a torn or mixed up element shows.  */
+static int
+cmp (const void *a, const void *b)
+{
+  ncmp++;
+  return *(const unsigned char *) a - *(const unsigned char *) b;
+}
+
+static int
+cmp_r (const void *a, const void *b, void *arg)
+{
+  (*(unsigned long *) arg)++;
+  return *(const unsigned char *) b - *(const unsigned char *) a;
+}
+
+static int
+key (int pattern, size_t i, size_t n)
+{
+  switch (pattern)
+    {
+    case 0:			/* random */
+      return rand () & 0xff;
+    case 1:			/* sorted */
+      return i * 256 / n;
+    case 2:			/* reversed */
+      return 255 - i * 256 / n;
+    case 3:			/* organ pipe */
+      return (i < n / 2 ? i : n - 1 - i) * 511 / n;
+    case 4:			/* all equal */
+      return 42;
+    default:			/* sorted, with a few swapped */
+      return i % 97 == 0 ? rand () & 0xff : i * 256 / n;
+    }
+}
+
+static void
+fill (int pattern, size_t n, size_t es)
+{
+  size_t i;
+
+  memset (counts, 0, sizeof (counts));
+  for (i = 0; i < n; i++)
+    {
+      int k = key (pattern, i, n);
+      memset (buf + i * es, k, es);
+      counts[k]++;
+    }
+}
+
+static void
+check_sorted (size_t n, size_t es, int dir)
+{
+  size_t i, j;
+  unsigned char *p;
+
+  for (i = 0; i < n; i++)
+    {
+      p = buf + i * es;
+      for (j = 1; j < es; j++)
+	CHECK (p[j] == p[0]);
+      if (i > 0)
+	CHECK (dir * (p[0] - p[-es]) >= 0);
+      CHECK (counts[p[0]]-- > 0);
+    }
+}
+
+static int *val;
+static int gas, nsolid, candidate;
+
+/* From "A Killer Adversary for Quicksort", M. D. McIlroy, 1999.  Values
+   are fixed as late as possible, always against the pivot.  */
+static int
+adversary (const void *px, const void *py)
+{
+  int x = *(const int *) px, y = *(const int *) py;
+
+  ncmp++;
+  if (val[x] == gas && val[y] == gas)
+    val[x == candidate ? x : y] = nsolid++;
+  if (val[x] == gas)
+    candidate = x;
+  else if (val[y] == gas)
+    candidate = y;
+  return val[x] - val[y];
+}
+
+static int
+intcmp (const void *a, const void *b)
+{
+  ncmp++;
+  return *(const int *) a < *(const int *) b ? -1
+	 : *(const int *) a > *(const int *) b;
+}
+
+int
+main (void)
+{
+  size_t n, s, es;
+  int pattern, i, *ptr, log2n;
+  unsigned long ncmp_r;
+
+  for (s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+    for (n = 0; n <= MAXN; n += n < 40 ? 1 : n / 2)
+      for (pattern = 0; pattern < 6; pattern++)
+	{
+	  es = sizes[s];
+	  fill (pattern, n, es);
+	  qsort (buf, n, es, cmp);
+	  check_sorted (n, es, 1);
+
+	  /* qsort_r, descending, with a misaligned array.  */
+	  fill (pattern, n, es);
+	  memmove (buf + 1, buf, n * es);
+	  ncmp_r = 0;
+	  qsort_r (buf + 1, n, es, cmp_r, &ncmp_r);
+	  memmove (buf, buf + 1, n * es);
+	  check_sorted (n, es, -1);
+	  CHECK (n < 2 || ncmp_r >= n - 1);
+	}
+
+  n = MAXN;
+  for (log2n = 0; (1u << log2n) < n; log2n++)
+    ;
+  ptr = malloc (n * sizeof (int));
+  val = malloc (n * sizeof (int));
+  CHECK (ptr != NULL && val != NULL);
+  gas = n - 1;
+  nsolid = 0;
+  for (i = 0; i < (int) n; i++)
+    {
+      ptr[i] = i;
+      val[i] = gas;
+    }
+  ncmp = 0;
+  qsort (ptr, n, sizeof (int), adversary);
+  CHECK (ncmp < 4 * n * log2n);
+
+  /* The input the adversary made up, sorted again for real.  */
+  ncmp = 0;
+  qsort (val, n, sizeof (int), intcmp);
+  CHECK (ncmp < 4 * n * log2n);
+  for (i = 1; i < (int) n; i++)
+    CHECK (val[i - 1] <= val[i]);
+
+  exit (0);
+}
@@ -0,0 +1,122 @@
+/* Check that a printf call recorded by blog_printf and formatted by
+   blog_snprintf gives the same text as snprintf, and that the ring
+   wraps, drops records that do not fit and hands them out in order.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "check.h"
+
+asm (".global _printf_float");
+asm (".global _printf_c99");
+
+static unsigned char ring[1024];
+static blog_t log;
+
+/* Record ARGS with FMT, read the record back, and compare its text with
+   what snprintf makes of the same arguments.  */
+#define SAME(fmt, ...)							\
+  do									\
+    {									\
+      unsigned char rec[BLOG_RECMAX];					\
+      char b1[256], b2[256];						\
+      int len, n1, n2;							\
+									\
+      CHECK (blog_printf (&log, fmt, __VA_ARGS__) > 0);			\
+      len = blog_read (&log, rec, sizeof rec);				\
+      CHECK (len > 0);							\
+      n1 = snprintf (b1, sizeof b1, fmt, __VA_ARGS__);			\
+      n2 = blog_snprintf (b2, sizeof b2, NULL, rec, len);		\
+      CHECK (n1 == n2);							\
+      CHECK (strcmp (b1, b2) == 0);					\
+    }									\
+  while (0)
+
+int
+main (void)
+{
+  unsigned char rec[BLOG_RECMAX];
+  char buf[BLOG_RECMAX * 2], big[400];
+  const char *fmt;
+  int i, n, len;
+
+  blog_init (&log, ring, sizeof ring);
+  CHECK (blog_read (&log, rec, sizeof rec) == 0);
+
+  SAME ("plain text%s", "");
+  SAME ("%d|%5d|%-5d|%05d|%+d|% d|%.3d|%+.0d", 1, 2, 3, -4, 5, 6, 7, 0);
+  SAME ("%x %#X %#o %o %u %c %% %p", 255u, 255u, 8u, 0u, -1u, 'q',
+	(void *) ring);
+  SAME ("%*d|%-*d|%*d|%.*d|%*.*s|", 6, 1, 6, 2, -6, 3, 4, 5, 8, 2, "abc");
+  SAME ("%s|%10s|%-10s|%.2s|%.*s", "x", "right", "left", "cut", 3,
+	"abcdef");
+  SAME ("%hhd %hd %ld %lld %zu %jd %td %llx", 300, 70000, -1L,
+	-(1LL << 40), (size_t) 9, (long long) 10, (long) 11, ~0ULL);
+  SAME ("%f %.2e %10.3g %-+8.1f %#.0f %Lf", 3.25, 1e10, 0.0001, 2.5, 3.0,
+	(long double) 0.5);
+  SAME ("%d%n|%s", 42, &n, "after %n");
+
+  /* A null string is recorded as "(null)".  */
+  len = blog_printf (&log, "%s %d", (char *) NULL, 1);
+  CHECK (blog_read (&log, rec, sizeof rec) == len);
+  CHECK (blog_snprintf (buf, sizeof buf, NULL, rec, len) == 8);
+  CHECK (strcmp (buf, "(null) 1") == 0);
+
+  /* A string that does not fit is cut short to the size of a record.  */
+  memset (big, 'x', sizeof big - 1);
+  big[sizeof big - 1] = '\0';
+  CHECK (blog_printf (&log, "%s|", big) == BLOG_RECMAX);
+  len = blog_read (&log, rec, sizeof rec);
+  CHECK (len == BLOG_RECMAX);
+  n = blog_snprintf (buf, sizeof buf, NULL, rec, len);
+  CHECK (n > 200 && n < BLOG_RECMAX && buf[n - 1] == '|');
+  CHECK (strspn (buf, "x") == (size_t) n - 1);
+
+  /* A record can be formatted with a copy of its format, as a host
+     tool would, and into a short buffer.  */
+  fmt = "id=%d name=%s\n";
+  len = blog_printf (&log, fmt, 17, "seventeen");
+  CHECK (blog_read (&log, rec, 4) == EOF);
+  CHECK (blog_read (&log, rec, sizeof rec) == len);
+  strcpy (buf, fmt);
+  CHECK (blog_snprintf (buf + 64, 10, buf, rec, len) == 21);
+  CHECK (strcmp (buf + 64, "id=17 nam") == 0);
+
+  /* A record that does not match its format is refused.  */
+  errno = 0;
+  CHECK (blog_snprintf (buf, sizeof buf, "%d %d", rec, len) == EOF);
+  CHECK (errno == EINVAL);
+  CHECK (blog_snprintf (buf, sizeof buf, NULL, rec, len - 1) == EOF);
+
+  /* Fill the ring, checking that nothing is lost or reordered while it
+     wraps, and that what does not fit is counted and dropped.  */
+  for (i = 0; i < 1000; i++)
+    {
+      n = blog_printf (&log, "record %d %s", i, i % 3 ? "a" : "longer");
+      if (i % 7 == 0)
+	while ((len = blog_read (&log, rec, sizeof rec)) > 0)
+	  ;
+      CHECK (n > 0 || log._dropped > 0);
+    }
+  CHECK (log._dropped == 0);
+  while (blog_read (&log, rec, sizeof rec) > 0)
+    ;
+
+  blog_init (&log, ring, sizeof ring);
+  for (i = 0; blog_printf (&log, "record %d", i) > 0; i++)
+    ;
+  CHECK (i > 10 && log._dropped == 1);
+  for (n = 0; (len = blog_read (&log, rec, sizeof rec)) > 0; n++)
+    {
+      blog_snprintf (buf, sizeof buf, NULL, rec, len);
+      sprintf (big, "record %d", n);
+      CHECK (strcmp (buf, big) == 0);
+      /* Room freed at the front is reused.  */
+      if (n == i / 2)
+	CHECK (blog_printf (&log, "record %d", i) > 0);
+    }
+  CHECK (n == i + 1);
+
+  return 0;
+}
@@ -0,0 +1,220 @@
+/* Check the float only conversions of _printf_float32 and _scanf_float32:
+   %e and %f must give the digits ecvtbuf gets from _dtoa_r for the same
+   float, %.9g must read back to the same float, and scanf must return
+   the float nearest to the decimal number.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+asm (".global _printf_float32");
+asm (".global _scanf_float32");
+
+static unsigned long long state = 0x2545f4914f6cdd1dULL;
+
+static unsigned long long
+rnd (void)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+union fbits { float f; unsigned int i; };
+
+static float
+bits2f (unsigned int i)
+{
+  union fbits u;
+
+  u.i = i;
+  return u.f;
+}
+
+static unsigned int
+f2bits (float f)
+{
+  union fbits u;
+
+  u.f = f;
+  return u.i;
+}
+
+/* A random finite nonzero float, subnormal ones included.  */
+static float
+rnd_float (void)
+{
+  unsigned int i;
+
+  do
+    i = (unsigned int) rnd ();
+  while ((i & 0x7f800000) == 0x7f800000 || (i & 0x7fffffff) == 0);
+  return bits2f (i);
+}
+
+static void
+expect_e (char *out, double v, int prec)
+{
+  char digits[200];
+  int decpt, sign, exp;
+
+  ecvtbuf (v, prec + 1, &decpt, &sign, digits);
+  if (sign)
+    *out++ = '-';
+  *out++ = digits[0];
+  if (prec > 0)
+    {
+      *out++ = '.';
+      memcpy (out, digits + 1, prec);
+      out += prec;
+    }
+  exp = decpt - 1;
+  sprintf (out, "e%c%02d", exp < 0 ? '-' : '+', exp < 0 ? -exp : exp);
+}
+
+static void
+expect_f (char *out, double v, int prec)
+{
+  char digits[400], frac[400];
+  int decpt, sign, nd, n;
+
+  ecvtbuf (v, 20, &decpt, &sign, digits);
+  if (sign)
+    *out++ = '-';
+  nd = decpt + prec;
+  if (nd > 0)
+    {
+      ecvtbuf (v, nd, &decpt, &sign, digits);
+      if (decpt > nd)
+	{
+	  /* Rounded up to a power of ten.  */
+	  memcpy (out, digits, nd);
+	  out += nd;
+	  *out++ = '0';
+	  frac[0] = '\0';
+	}
+      else if (decpt > 0)
+	{
+	  memcpy (out, digits, decpt);
+	  out += decpt;
+	  strcpy (frac, digits + decpt);
+	}
+      else
+	{
+	  *out++ = '0';
+	  memset (frac, '0', -decpt);
+	  strcpy (frac - decpt, digits);
+	}
+    }
+  else
+    {
+      /* Rounds to 0 or to one unit in the last place.  */
+      int up = nd == 0 && (digits[0] > '5'
+			   || (digits[0] == '5' && strspn (digits + 1, "0") < 19));
+
+      *out++ = prec == 0 && up ? '1' : '0';
+      memset (frac, '0', prec);
+      frac[prec] = '\0';
+      if (prec > 0 && up)
+	frac[prec - 1] = '1';
+    }
+  n = strlen (frac);
+  while (n < prec)
+    frac[n++] = '0';
+  if (prec > 0)
+    {
+      *out++ = '.';
+      memcpy (out, frac, prec);
+      out += prec;
+    }
+  *out = '\0';
+}
+
+/* Check that scanf of S gives the float with bits I.  */
+static void
+check_scan (const char *s, unsigned int i)
+{
+  float f = 1;
+
+  CHECK (sscanf (s, "%f", &f) == 1);
+  CHECK (f2bits (f) == i);
+}
+
+int
+main (void)
+{
+  char buf[512], ref[512];
+  float f, g;
+  double d, lo, hi;
+  int i, prec, n;
+
+  sprintf (buf, "%.0f %.1f %e %g", 2.5f, 0.25f, 1.0f, 100000.0f);
+  CHECK (strcmp (buf, "2 0.2 1.000000e+00 100000") == 0);
+  sprintf (buf, "%f %g %.3e %f", 16777216.0f, 0.1, 1e300, -1e-300);
+  CHECK (strcmp (buf, "16777216.000000 0.1 inf -0.000000") == 0);
+  sprintf (buf, "%.10g %.2e %#g %08.3f", 3.4028234663852886e38, 0.0,
+	   1.0, -2.5);
+  CHECK (strcmp (buf, "3.402823466e+38 0.00e+00 1.00000 -002.500") == 0);
+  sprintf (buf, "%.45f", bits2f (1));
+  CHECK (strcmp (buf, "0.000000000000000000000000000000000000000000001") == 0);
+
+  /* Ties round to even, and digits beyond the exact value are zeros.  */
+  check_scan ("16777217", 0x4b800000);
+  check_scan ("16777219", 0x4b800002);
+  check_scan ("16777217.000000000000000000000000000001", 0x4b800001);
+  check_scan ("7.00649232162408535461864791644958065640130970938257885878534141944895541342930300743319094181060791015625e-46", 0);
+  check_scan ("7.006492321624085354618647916449580656401309709382578858785341419448955413429303007433190941810607910156251e-46", 1);
+  check_scan ("1e-45", 1);
+  check_scan ("3.4028235e38", 0x7f7fffff);
+  check_scan ("3.4028236e38", 0x7f800000);
+  check_scan ("-1e39", 0xff800000);
+  check_scan ("1e-99999", 0);
+  check_scan ("-0", 0x80000000);
+  check_scan ("0.000000000000000000000000000000000000000000000000000e99", 0);
+  check_scan ("-inf", 0xff800000);
+  check_scan ("1.17549435e-38", 0x00800000);
+  check_scan ("0.1", 0x3dcccccd);
+  CHECK (sscanf ("nan", "%f", &f) == 1 && f != f);
+  CHECK (sscanf ("0.1", "%lf", &d) == 1 && d == (double) 0.1f);
+
+  for (i = 0; i < 20000; i++)
+    {
+      f = rnd_float ();
+
+      for (prec = 0; prec <= 22; prec++)
+	{
+	  sprintf (buf, "%.*e", prec, f);
+	  expect_e (ref, f, prec);
+	  CHECK (strcmp (buf, ref) == 0);
+	  sprintf (buf, "%.*f", prec, f);
+	  expect_f (ref, f, prec);
+	  CHECK (strcmp (buf, ref) == 0);
+	}
+      prec = 23 + rnd () % 100;
+      sprintf (buf, "%.*e", prec, f);
+      expect_e (ref, f, prec);
+      CHECK (strcmp (buf, ref) == 0);
+
+      sprintf (buf, "%.9g", f);
+      CHECK (sscanf (buf, "%f", &g) == 1 && f2bits (g) == f2bits (f));
+
+      /* A random decimal number reads as the float nearest to the
+	 double strtod makes of it, unless that is a halfway point.  */
+      n = 1 + rnd () % 30;
+      buf[0] = '1' + rnd () % 9;
+      for (prec = 1; prec < n; prec++)
+	buf[prec] = '0' + rnd () % 10;
+      sprintf (buf + n, "e%d", (int) (rnd () % 90) - 50 - n);
+      d = strtod (buf, NULL);
+      g = (float) d;
+      lo = ((double) bits2f (f2bits (g) - 1) + g) / 2;
+      hi = ((double) bits2f (f2bits (g) + 1) + g) / 2;
+      CHECK (sscanf (buf, "%f", &f) == 1);
+      if (d != lo && d != hi && f2bits (g) != 0 && f2bits (g) < 0x7f800000)
+	CHECK (f2bits (f) == f2bits (g));
+    }
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+/* Check that fseek and ftell on a read stream land on the right byte,
+   whether or not the target is in the buffer, and that they clear EOF
+   and drop ungetc data.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+#define NAME "fseek.tmp"
+#define SIZE (3 * BUFSIZ + 100)
+
+static int
+pat (long i)
+{
+  return (i * 7 + i / 251) & 0xff;
+}
+
+static void
+at (FILE *fp, long pos)
+{
+  CHECK (ftell (fp) == pos);
+  CHECK (getc (fp) == pat (pos));
+  CHECK (ftell (fp) == pos + 1);
+}
+
+int
+main (void)
+{
+  unsigned char buf[64];
+  FILE *fp;
+  long i, pos;
+  size_t j, n;
+
+  fp = fopen (NAME, "w");
+  CHECK (fp != NULL);
+  for (i = 0; i < SIZE; i++)
+    putc (pat (i), fp);
+  CHECK (fclose (fp) == 0);
+
+  fp = fopen (NAME, "r");
+  CHECK (fp != NULL);
+  for (i = 0; i < 10; i++)
+    CHECK (getc (fp) == pat (i));
+  CHECK (fseek (fp, 3, SEEK_SET) == 0);
+  at (fp, 3);
+  CHECK (fseek (fp, -2, SEEK_CUR) == 0);
+  at (fp, 2);
+  CHECK (fseek (fp, 100, SEEK_CUR) == 0);
+  at (fp, 103);
+  CHECK (fseek (fp, 2 * BUFSIZ + 5, SEEK_SET) == 0);
+  at (fp, 2 * BUFSIZ + 5);
+  CHECK (fseek (fp, -BUFSIZ, SEEK_CUR) == 0);
+  at (fp, BUFSIZ + 6);
+
+  /* EOF is cleared by a seek, also into the buffer.  */
+  CHECK (fseek (fp, -1, SEEK_END) == 0);
+  at (fp, SIZE - 1);
+  CHECK (getc (fp) == EOF && feof (fp));
+  CHECK (fseek (fp, -3, SEEK_CUR) == 0);
+  CHECK (!feof (fp));
+  at (fp, SIZE - 3);
+  CHECK (fseek (fp, SIZE + 10, SEEK_SET) == 0);
+  CHECK (getc (fp) == EOF);
+  CHECK (fseek (fp, 0, SEEK_SET) == 0);
+  at (fp, 0);
+
+  /* A seek drops what ungetc pushed back.  */
+  CHECK (ungetc ('Z', fp) == 'Z');
+  CHECK (ftell (fp) == 0);
+  CHECK (fseek (fp, 0, SEEK_CUR) == 0);
+  at (fp, 0);
+  CHECK (ungetc ('Z', fp) == 'Z');
+  CHECK (fseek (fp, 5, SEEK_SET) == 0);
+  at (fp, 5);
+
+  /* After an fflush the file is read again at the same place.  */
+  CHECK (fflush (fp) == 0);
+  CHECK (fseek (fp, -3, SEEK_CUR) == 0);
+  at (fp, 3);
+
+  /* Short reads and seeks of every size, back and forth.  */
+  srand (1);
+  pos = 3 + 1;
+  for (i = 0; i < 2000; i++)
+    {
+      n = rand () % sizeof buf;
+      if (rand () % 4 == 0)
+	pos = rand () % SIZE;
+      else
+	pos -= rand () % (2 * sizeof buf);
+      if (pos < 0)
+	pos = 0;
+      CHECK (fseek (fp, i % 2 ? pos : pos - ftell (fp),
+		    i % 2 ? SEEK_SET : SEEK_CUR) == 0);
+      n = fread (buf, 1, n, fp);
+      for (j = 0; j < n; j++)
+	CHECK (buf[j] == pat (pos + j));
+      pos += n;
+      CHECK (ftell (fp) == pos);
+    }
+
+  CHECK (fclose (fp) == 0);
+  remove (NAME);
+  return 0;
+}
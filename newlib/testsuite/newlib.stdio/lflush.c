@@ -0,0 +1,88 @@
+/* Check that reading from an unbuffered stream first flushes the
+   pending output of every line buffered stream, with many streams open
+   and after streams are closed and their FILEs reused.  */
+
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+
+#define NLBF 20
+#define NFULL 40
+
+static char name[NLBF + NFULL][16];
+
+/* Return whether file I holds TEXT.  */
+static int
+holds (int i, const char *text)
+{
+  char buf[32];
+  FILE *fp;
+  size_t n;
+
+  fp = fopen (name[i], "r");
+  if (fp == NULL)
+    return 0;
+  n = fread (buf, 1, sizeof buf - 1, fp);
+  buf[n] = '\0';
+  fclose (fp);
+  return strcmp (buf, text) == 0;
+}
+
+int
+main (void)
+{
+  FILE *lbf[NLBF], *full[NFULL], *in;
+  int i;
+
+  for (i = 0; i < NLBF + NFULL; i++)
+    sprintf (name[i], "lflush%d.tmp", i);
+  in = fopen (name[0], "w");
+  CHECK (in != NULL);
+  fputs ("input", in);
+  CHECK (fclose (in) == 0);
+  in = fopen (name[0], "r");
+  CHECK (in != NULL);
+  CHECK (setvbuf (in, NULL, _IONBF, 0) == 0);
+
+  for (i = 0; i < NFULL; i++)
+    {
+      full[i] = fopen (name[NLBF + i], "w");
+      CHECK (full[i] != NULL);
+    }
+  for (i = 1; i < NLBF; i++)
+    {
+      lbf[i] = fopen (name[i], "w");
+      CHECK (lbf[i] != NULL);
+      CHECK (setvbuf (lbf[i], NULL, _IOLBF, 64) == 0);
+      fputs ("a", lbf[i]);
+    }
+
+  CHECK (getc (in) == 'i');
+  for (i = 1; i < NLBF; i++)
+    CHECK (holds (i, "a"));
+
+  /* Closed streams are forgotten, and their FILEs reused.  */
+  for (i = 1; i < NLBF; i += 2)
+    CHECK (fclose (lbf[i]) == 0);
+  for (i = 1; i < NLBF; i += 2)
+    {
+      lbf[i] = fopen (name[i], "a");
+      CHECK (lbf[i] != NULL);
+      if (i % 4 == 1)
+	CHECK (setvbuf (lbf[i], NULL, _IOLBF, 64) == 0);
+    }
+  for (i = 1; i < NLBF; i++)
+    fputs ("b", lbf[i]);
+  CHECK (getc (in) == 'n');
+  for (i = 1; i < NLBF; i++)
+    CHECK (holds (i, i % 4 == 3 ? "a" : "ab"));
+
+  for (i = 1; i < NLBF; i++)
+    CHECK (fclose (lbf[i]) == 0);
+  for (i = 0; i < NFULL; i++)
+    CHECK (fclose (full[i]) == 0);
+  CHECK (fclose (in) == 0);
+  for (i = 0; i < NLBF + NFULL; i++)
+    remove (name[i]);
+  return 0;
+}
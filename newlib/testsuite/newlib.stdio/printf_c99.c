@@ -0,0 +1,91 @@
+/* Check the conversions with C99 length modifiers, which newlib-nano
+   only supports when _printf_c99 is linked in.  */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "check.h"
+
+asm (".global _printf_c99");
+
+static char buf[128];
+
+#define TEST(expect, ...) \
+  do \
+    { \
+      int n = sprintf (buf, __VA_ARGS__); \
+      CHECK (strcmp (buf, expect) == 0); \
+      CHECK (n == (int) strlen (expect)); \
+    } \
+  while (0)
+
+int
+main (void)
+{
+  long long ll;
+  signed char hh;
+  size_t z;
+  intmax_t j;
+  ptrdiff_t t;
+  char ref[32];
+  unsigned long long p;
+  int i;
+
+  TEST ("-128 255 7f", "%hhd %hhu %hhx", -128, 255, 127);
+  TEST ("-1 255", "%hhd %hhu", 255, -1);
+  TEST ("-9223372036854775808", "%lld", LLONG_MIN);
+  TEST ("9223372036854775807", "%lli", LLONG_MAX);
+  TEST ("18446744073709551615", "%llu", ULLONG_MAX);
+  TEST ("ffffffffffffffff", "%llx", ULLONG_MAX);
+  TEST ("0X123456789ABCDEF0", "%#llX", 0x123456789abcdef0ULL);
+  TEST ("1777777777777777777777", "%llo", ULLONG_MAX);
+  TEST ("040000000000", "%#llo", 040000000000ULL);
+  TEST ("  -00042", "%8.5lld", -42LL);
+  TEST ("4294967296|", "%-5llu|", 4294967296ULL);
+  TEST ("", "%.0lld", 0LL);
+  /* %zd takes the signed type of the size of size_t.  That is not
+     _ssize_t, which is int on some targets with a 64-bit size_t.  */
+  TEST ("123 -7 -1 456", "%zu %zd %jd %td", (size_t) 123, (ptrdiff_t) -7,
+	(intmax_t) -1, (ptrdiff_t) 456);
+  TEST ("12 x 345", "%d %c %lld", 12, 'x', 345LL);
+
+  /* Arguments after a C99 conversion are still found.  */
+  TEST ("1 2 3 4 5 6", "%hhd %lld %zu %jd %td %d", 1, 2LL, (size_t) 3,
+	(intmax_t) 4, (ptrdiff_t) 5, 6);
+
+  /* %n with each length modifier.  */
+  TEST ("abc", "abc%hhn", &hh);
+  CHECK (hh == 3);
+  TEST ("abcd", "abcd%lln", &ll);
+  CHECK (ll == 4);
+  TEST ("ab", "ab%zn", &z);
+  CHECK (z == 2);
+  TEST ("a", "a%jn", &j);
+  CHECK (j == 1);
+  TEST ("abcde", "abcde%tn", &t);
+  CHECK (t == 5);
+
+  /* Powers of ten across the width of long long.  */
+  for (p = 1, i = 1; i < 20; i++)
+    {
+      unsigned long long v;
+
+      p *= 10;
+      for (v = p - 1; v != p + 2; v++)
+	{
+	  unsigned long long r = v;
+	  char *cp = ref + sizeof ref;
+
+	  *--cp = '\0';
+	  do
+	    *--cp = '0' + r % 10;
+	  while ((r /= 10) != 0);
+	  TEST (cp, "%llu", v);
+	}
+    }
+
+  return 0;
+}
@@ -0,0 +1,84 @@
+/* Check the conversions with C99 length modifiers when _printf_c99 is
+   not linked in.  Those for types no wider than long are printed as
+   with l or no modifier.  The others print nothing and must not add to
+   the count returned.  The formats are passed through a variable, so
+   that the compiler does not work out the return values itself.  */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include "check.h"
+
+static char buf[128];
+static const char *volatile format;
+
+#define TEST(expect, fmt, ...) \
+  do \
+    { \
+      int n; \
+      format = fmt; \
+      n = sprintf (buf, format, __VA_ARGS__); \
+      CHECK (strcmp (buf, expect) == 0); \
+      CHECK (n == (int) strlen (expect)); \
+    } \
+  while (0)
+
+#define WIDE(type) (sizeof (type) > sizeof (long))
+
+int
+main (void)
+{
+  signed char hh;
+  long long ll;
+  size_t z;
+  ptrdiff_t t;
+  intmax_t j;
+
+  TEST ("-128 255 7f", "%hhd %hhu %hhx", -128, 255, 127);
+  TEST ("-1 255", "%hhd %hhu", 255, -1);
+  /* %zd takes the signed type of the size of size_t.  That is not
+     _ssize_t, which is int on some targets with a 64-bit size_t.  */
+  TEST ("123 -7 456", "%zu %zd %td", (size_t) 123, (ptrdiff_t) -7,
+	(ptrdiff_t) 456);
+  TEST ("abc", "abc%hhn", &hh);
+  CHECK (hh == 3);
+  TEST ("ab", "ab%zn", &z);
+  CHECK (z == 2);
+  TEST ("abcde", "abcde%tn", &t);
+  CHECK (t == 5);
+
+  if (WIDE (long long))
+    {
+      TEST ("xy", "x%lldy", 5LL);
+      TEST ("", "%lld%llu", LLONG_MIN, ULLONG_MAX);
+      TEST ("1  3", "%d %lld %d", 1, 2LL, 3);
+    }
+  else
+    {
+      TEST ("x5y", "x%lldy", 5LL);
+      TEST ("-9223372036854775808 18446744073709551615", "%lld %llu",
+	    LLONG_MIN, ULLONG_MAX);
+      TEST ("1 2 3", "%d %lld %d", 1, 2LL, 3);
+    }
+  if (WIDE (intmax_t))
+    TEST ("1  3", "%d %jd %d", 1, (intmax_t) 2, 3);
+  else
+    TEST ("1 2 3", "%d %jd %d", 1, (intmax_t) 2, 3);
+  TEST ("abcd", "abcd%lln", &ll);
+  if (!WIDE (long long))
+    CHECK (ll == 4);
+  TEST ("a", "a%jn", &j);
+  if (!WIDE (intmax_t))
+    CHECK (j == 1);
+
+  /* Only h and l may be doubled.  */
+  TEST ("zu7", "%zzu%d", 7);
+  TEST ("jd7", "%jjd%d", 7);
+  TEST ("td7", "%ttd%d", 7);
+  TEST ("Ld7", "%LLd%d", 7);
+
+  return 0;
+}
@@ -0,0 +1,163 @@
+/* Check %e and %f of printf against the digits ecvtbuf gets from
+   _dtoa_r, for random doubles and all the precisions the fast path of
+   __cvt handles and a few more, and check that %.17g reads back with
+   strtod to the same double.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+asm (".global _printf_float");
+
+static unsigned long long state = 0x2545f4914f6cdd1dULL;
+
+static unsigned long long
+rnd (void)
+{
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+/* A random finite nonzero double, mostly of moderate magnitude.  */
+static double
+rnd_double (void)
+{
+  union { double d; unsigned long long u; } x;
+  unsigned long long bits = rnd ();
+  unsigned long long exp;
+
+  if ((bits & 7) == 0)
+    exp = 1 + (rnd () % 2046);
+  else
+    exp = 1023 - 70 + (rnd () % 140);
+  x.u = (bits & 0x800fffffffffffffULL) | (exp << 52);
+  return x.d;
+}
+
+static void
+expect_e (char *out, double v, int prec)
+{
+  char digits[64];
+  int decpt, sign, exp;
+
+  ecvtbuf (v, prec + 1, &decpt, &sign, digits);
+  if (sign)
+    *out++ = '-';
+  *out++ = digits[0];
+  if (prec > 0)
+    {
+      *out++ = '.';
+      memcpy (out, digits + 1, prec);
+      out += prec;
+    }
+  exp = decpt - 1;
+  sprintf (out, "e%c%02d", exp < 0 ? '-' : '+', exp < 0 ? -exp : exp);
+}
+
+static void
+expect_f (char *out, double v, int prec)
+{
+  char digits[400], frac[400];
+  int decpt, sign, nd, n;
+
+  ecvtbuf (v, 20, &decpt, &sign, digits);
+  if (sign)
+    *out++ = '-';
+  nd = decpt + prec;
+  if (nd > 0)
+    {
+      ecvtbuf (v, nd, &decpt, &sign, digits);
+      if (decpt > nd)
+	{
+	  /* Rounded up to a power of ten.  */
+	  memcpy (out, digits, nd);
+	  out += nd;
+	  *out++ = '0';
+	  frac[0] = '\0';
+	}
+      else if (decpt > 0)
+	{
+	  memcpy (out, digits, decpt);
+	  out += decpt;
+	  strcpy (frac, digits + decpt);
+	}
+      else
+	{
+	  *out++ = '0';
+	  memset (frac, '0', -decpt);
+	  strcpy (frac - decpt, digits);
+	}
+    }
+  else
+    {
+      /* Rounds to 0 or to one unit in the last place.  */
+      int up = nd == 0 && (digits[0] > '5'
+			   || (digits[0] == '5' && strspn (digits + 1, "0") < 19));
+
+      *out++ = prec == 0 && up ? '1' : '0';
+      memset (frac, '0', prec);
+      frac[prec] = '\0';
+      if (prec > 0 && up)
+	frac[prec - 1] = '1';
+    }
+  n = strlen (frac);
+  while (n < prec)
+    frac[n++] = '0';
+  if (prec > 0)
+    {
+      *out++ = '.';
+      memcpy (out, frac, prec);
+      out += prec;
+    }
+  *out = '\0';
+}
+
+int
+main (void)
+{
+  char buf[512], ref[512];
+  double v;
+  int i, prec;
+
+  /* Ties round to even, as _dtoa_r does.  */
+  sprintf (buf, "%.0f %.0f %.0f %.0f", 0.5, 1.5, 2.5, 3.5);
+  CHECK (strcmp (buf, "0 2 2 4") == 0);
+  sprintf (buf, "%.2f %.2f %.1e %.0e", 0.125, 0.375, 1.25, 2.5e10);
+  CHECK (strcmp (buf, "0.12 0.38 1.2e+00 2e+10") == 0);
+  sprintf (buf, "%f %e %g %g %g", 1.0, 9.9999996, 100000.0, 1e6, 1e-5);
+  CHECK (strcmp (buf, "1.000000 1.000000e+01 100000 1e+06 1e-05") == 0);
+  sprintf (buf, "%.3f %.3f %.3f %.0f", 0.0004, 0.0005, 0.0006, 0.3);
+  CHECK (strcmp (buf, "0.000 0.001 0.001 0") == 0);
+  sprintf (buf, "%.2f %g %#g %.3g", 1e15, 123456789.0, 0.5, 99.96);
+  CHECK (strcmp (buf, "1000000000000000.00 1.23457e+08 0.500000 100") == 0);
+  sprintf (buf, "%.15g %.17g %.1f", 0.1, 0.1, 18446744073709551615.0);
+  CHECK (strcmp (buf, "0.1 0.10000000000000001 18446744073709551616.0") == 0);
+
+  for (i = 0; i < 20000; i++)
+    {
+      v = rnd_double ();
+
+      for (prec = 0; prec <= 22; prec++)
+	{
+	  sprintf (buf, "%.*e", prec, v);
+	  expect_e (ref, v, prec);
+	  CHECK (strcmp (buf, ref) == 0);
+	}
+
+      if (v > -1e40 && v < 1e40)
+	for (prec = 0; prec <= 22; prec++)
+	  {
+	    sprintf (buf, "%.*f", prec, v);
+	    expect_f (ref, v, prec);
+	    CHECK (strcmp (buf, ref) == 0);
+	  }
+
+      sprintf (buf, "%.17g", v);
+      CHECK (strtod (buf, NULL) == v);
+    }
+
+  return 0;
+}
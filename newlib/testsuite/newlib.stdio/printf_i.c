@@ -0,0 +1,80 @@
+/* Check the integer conversions of printf against values worked out by
+   hand, for the digit counts and bases where the conversion loop takes
+   different paths.  */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "check.h"
+
+static char buf[128];
+
+#define TEST(expect, ...) \
+  do \
+    { \
+      int n = sprintf (buf, __VA_ARGS__); \
+      CHECK (strcmp (buf, expect) == 0); \
+      CHECK (n == (int) strlen (expect)); \
+    } \
+  while (0)
+
+int
+main (void)
+{
+  unsigned long p;
+  char ref[32];
+  int i;
+
+  TEST ("0", "%d", 0);
+  TEST ("7", "%d", 7);
+  TEST ("42", "%d", 42);
+  TEST ("-99", "%d", -99);
+  TEST ("100", "%u", 100u);
+  TEST ("1009", "%i", 1009);
+  TEST ("-2147483648", "%d", INT_MIN);
+  TEST ("4294967295", "%u", UINT_MAX);
+  TEST ("-9223372036854775808", "%ld", LONG_MIN);
+  TEST ("18446744073709551615", "%lu", ULONG_MAX);
+  TEST ("-32768", "%hd", -32768);
+  TEST ("65535", "%hu", 65535);
+
+  TEST ("0", "%x", 0u);
+  TEST ("deadbeef", "%x", 0xdeadbeefu);
+  TEST ("DEADBEEF", "%X", 0xdeadbeefu);
+  TEST ("0xff", "%#x", 255u);
+  TEST ("0", "%#x", 0u);
+  TEST ("17777777777", "%o", 017777777777u);
+  TEST ("010", "%#o", 8u);
+  TEST ("0", "%#o", 0u);
+  TEST ("0", "%#.0o", 0u);
+  TEST ("  010", "%#5o", 8u);
+
+  TEST ("", "%.0d", 0);
+  TEST ("  007", "%5.3d", 7);
+  TEST ("-0042", "%05d", -42);
+  TEST ("+42  ", "%-+5d", 42);
+  TEST (" 42", "% d", 42);
+  TEST ("a     |", "%-6x|", 10u);
+  TEST ("id=12 v=0000beef s -3", "id=%u v=%08x %s %d", 12u, 0xbeefu, "s", -3);
+
+  /* Every power of ten and its neighbours.  */
+  for (p = 1, i = 1; i < 20; i++)
+    {
+      unsigned long v;
+
+      p *= 10;
+      for (v = p - 1; v != p + 2; v++)
+	{
+	  unsigned long t = v;
+	  char *cp = ref + sizeof ref;
+
+	  *--cp = '\0';
+	  do
+	    *--cp = '0' + t % 10;
+	  while ((t /= 10) != 0);
+	  TEST (cp, "%lu", v);
+	}
+    }
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/* Check that printing with a format compiled by pfmt_compile gives the
+   same output as printing with the format itself, and that pfmt_compile
+   counts and rejects what it should.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+asm (".global _printf_float");
+asm (".global _printf_c99");
+
+#define NPF 16
+
+/* Print ARGS with FMT both ways and compare.  */
+#define SAME(fmt, ...)							\
+  do									\
+    {									\
+      pfmt_t pf[NPF];							\
+      char b1[256], b2[256];						\
+      int n1, n2;							\
+									\
+      CHECK (pfmt_compile (pf, NPF, fmt) <= NPF);			\
+      n1 = snprintf (b1, sizeof b1, fmt, __VA_ARGS__);			\
+      n2 = snprintf_pfmt (b2, sizeof b2, pf, __VA_ARGS__);		\
+      CHECK (n1 == n2);							\
+      CHECK (strcmp (b1, b2) == 0);					\
+    }									\
+  while (0)
+
+static char out[512];
+static int outlen;
+
+static int
+collect (void *cookie, const char *buf, int n)
+{
+  memcpy (out + outlen, buf, n);
+  outlen += n;
+  return n;
+}
+
+int
+main (void)
+{
+  pfmt_t pf[NPF];
+  char buf[64];
+  int i, n;
+  short s;
+  long long ll;
+  FILE *fp;
+
+  SAME ("plain text%s", "");
+  SAME ("%d|%5d|%-5d|%05d|%+d|% d|%.3d|%+.0d", 1, 2, 3, -4, 5, 6, 7, 0);
+  SAME ("%x %#X %#o %o %u %c %%", 255u, 255u, 8u, 0u, -1u, 'q');
+  SAME ("%*d|%-*d|%*d|%.*d|%*.*s|", 6, 1, 6, 2, -6, 3, 4, 5, 8, 2, "abc");
+  SAME ("%s|%10s|%-10s|%.2s|%p", "x", "right", "left", "cut", (void *) 16);
+  SAME ("%hhd %hd %ld %lld %zu %jd %td", 300, 70000, -1L, -(1LL << 40),
+	(size_t) 9, (long long) 10, (long) 11);
+  SAME ("%f %.2e %10.3g %-+8.1f %#.0f %a", 3.25, 1e10, 0.0001, 2.5, 3.0,
+	1.0);
+  SAME ("%.*f|%*.*e", -1, 0.5, 12, 3, -1.5);
+  SAME ("%s%s%s%s%s%s%s%s%s%s%s%s%s%s", "a", "b", "c", "d", "e", "f", "g",
+	"h", "i", "j", "k", "l", "m", "n");
+
+  /* %n stores the count so far; a bad conversion is printed as is.  */
+  CHECK (pfmt_compile (pf, NPF, "ab%ncd%hn%lln") == 4);
+  CHECK (snprintf_pfmt (buf, sizeof buf, pf, &i, &s, &ll) == 4);
+  CHECK (strcmp (buf, "abcd") == 0 && i == 2 && s == 4 && ll == 4);
+  SAME ("%y%d", 5);
+
+  /* The count covers the last literal even when it is empty or the array
+     is too short, so the caller can size the array.  */
+  CHECK (pfmt_compile (pf, NPF, "") == 1);
+  CHECK (pfmt_compile (pf, NPF, "%d") == 2);
+  CHECK (pfmt_compile (pf, 0, "a %d b %s c") == 3);
+  CHECK (pfmt_compile (pf, 1, "a %d b %s c") == 3);
+  CHECK (pf[0]._litlen == 2 && pf[0]._code == 'd');
+  CHECK (pfmt_compile (pf, NPF, "100%%") == 2);
+  CHECK (pfmt_compile (pf, NPF, "trailing %") == 1);
+  CHECK (pfmt_compile (pf, NPF, "%32767d") == 2);
+  CHECK (pfmt_compile (pf, NPF, "%32768d") == -1);
+  CHECK (pfmt_compile (pf, NPF, "%.99999f") == -1);
+
+  /* snprintf_pfmt truncates like snprintf.  */
+  pfmt_compile (pf, NPF, "%s=%08x;");
+  for (i = 0; i <= 14; i++)
+    {
+      memset (buf, 'z', sizeof buf);
+      CHECK (snprintf_pfmt (buf, i, pf, "key", 0xbeefu) == 13);
+      if (i > 0)
+	CHECK (strncmp (buf, "key=0000beef;", i - 1) == 0
+	       && buf[i - 1] == '\0');
+      CHECK (buf[i] == 'z');
+    }
+
+  fp = funopen (NULL, NULL, collect, NULL, NULL);
+  CHECK (fp != NULL);
+  pfmt_compile (pf, NPF, "[%-6s] %3d: %s\n");
+  for (i = 0; i < 3; i++)
+    CHECK (fprintf_pfmt (fp, pf, "info", i, "message") == 22);
+  fclose (fp);
+  CHECK (outlen == 66);
+  CHECK (memcmp (out, "[info  ]   0: message\n[info  ]   1: message\n"
+		 "[info  ]   2: message\n", 66) == 0);
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+/* Check that printf output written in spans, rather than a character
+   at a time, still pads, truncates and buffers as before: for strings,
+   for snprintf and asprintf near the end of their buffer, and for fully,
+   line and unbuffered streams.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "check.h"
+
+asm (".global _printf_float");
+
+static char out[4096];
+static int outlen, writes, partial;
+
+/* Collect what a stream writes, and count the writes that do not end
+   a line.  */
+static int
+collect (void *cookie, const char *buf, int n)
+{
+  memcpy (out + outlen, buf, n);
+  outlen += n;
+  writes++;
+  if (buf[n - 1] != '\n')
+    partial++;
+  return n;
+}
+
+static void
+check_stream (int mode, const char *expect)
+{
+  FILE *fp = funopen (NULL, NULL, collect, NULL, NULL);
+  int i;
+
+  CHECK (fp != NULL);
+  CHECK (setvbuf (fp, NULL, mode, 128) == 0);
+  outlen = writes = partial = 0;
+  for (i = 0; i < 3; i++)
+    CHECK (fprintf (fp, "line %d: %-24s|%30d|\n", i, "some text", -i)
+	   == (int) strlen (expect) / 3);
+  if (mode == _IOLBF)
+    CHECK (partial == 0 && writes >= 3);
+  fclose (fp);
+  CHECK (outlen == (int) strlen (expect));
+  CHECK (memcmp (out, expect, outlen) == 0);
+  /* An unbuffered stream gets one write per span, not per character.  */
+  if (mode == _IONBF)
+    CHECK (writes < outlen / 4);
+}
+
+int
+main (void)
+{
+  char buf[256], ref[256], expect[512], *p;
+  int i, n;
+
+  sprintf (buf, "[%40s]", "right");
+  memset (ref, ' ', 42);
+  memcpy (ref + 1 + 35, "right", 5);
+  ref[0] = '[';
+  strcpy (ref + 41, "]");
+  CHECK (strcmp (buf, ref) == 0);
+
+  sprintf (buf, "[%-37s]", "left");
+  memset (ref, ' ', 39);
+  memcpy (ref, "[left", 5);
+  strcpy (ref + 38, "]");
+  CHECK (strcmp (buf, ref) == 0);
+
+  sprintf (buf, "%033d|%-+20d|%#35x", -5, 7, 0xabcu);
+  CHECK (strcmp (buf, "-00000000000000000000000000000005|+7                  |"
+		 "                              0xabc") == 0);
+  sprintf (buf, "%.3s|%20.2s|%c%17c", "abcdef", "xyz", 'a', 'b');
+  CHECK (strcmp (buf, "abc|                  xy|a                b") == 0);
+  sprintf (buf, "%040.3f|%-25e|", -2.5, 1.0);
+  CHECK (strcmp (buf, "-00000000000000000000000000000000002.500|"
+		 "1.000000e+00             |") == 0);
+  sprintf (buf, "%.40f", 0.5);
+  CHECK (strcmp (buf, "0.5000000000000000000000000000000000000000") == 0);
+
+  /* snprintf stops at any byte, within a span or a pad.  */
+  sprintf (ref, "literal text %20s and %-20d end", "str", 42);
+  for (i = 0; i <= (int) strlen (ref) + 1; i++)
+    {
+      memset (buf, 'z', sizeof buf);
+      n = snprintf (buf, i, "literal text %20s and %-20d end", "str", 42);
+      CHECK (n == (int) strlen (ref));
+      if (i > 0)
+	{
+	  CHECK (strncmp (buf, ref, i - 1) == 0);
+	  CHECK (buf[i - 1] == '\0');
+	}
+      CHECK (buf[i] == 'z');
+    }
+
+  /* asprintf grows its buffer from 64 bytes in the middle of spans.  */
+  n = asprintf (&p, "%s%300s%s|%-200d|", "head ", "pad", " tail", 1);
+  CHECK (n == 5 + 300 + 5 + 202);
+  CHECK (strncmp (p, "head ", 5) == 0);
+  CHECK (strncmp (p + 302, "pad tail|1", 10) == 0);
+  CHECK (p[n - 1] == '|' && p[n] == '\0' && p[n - 2] == ' ');
+  free (p);
+
+  expect[0] = '\0';
+  for (i = 0; i < 3; i++)
+    sprintf (expect + strlen (expect), "line %d: %-24s|%30d|\n", i,
+	     "some text", -i);
+  check_stream (_IOFBF, expect);
+  check_stream (_IOLBF, expect);
+  check_stream (_IONBF, expect);
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/* Check the integer, string and character conversions of scanf, on a
+   string and on a stream that hands out one character at a time, so
+   that every conversion runs across the end of the read buffer.  */
+
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include "check.h"
+
+static const char *input;
+
+static int
+readone (void *cookie, char *buf, int n)
+{
+  if (*input == '\0')
+    return 0;
+  *buf = *input++;
+  return 1;
+}
+
+static FILE *
+slow (const char *str)
+{
+  input = str;
+  return funopen (NULL, readone, NULL, NULL, NULL);
+}
+
+int
+main (void)
+{
+  char s[64], t[64], c;
+  int a, b, n;
+  long l;
+  unsigned long ul;
+  short h;
+  void *p;
+  FILE *fp;
+
+  CHECK (sscanf ("42", "%d", &a) == 1 && a == 42);
+  CHECK (sscanf ("-0", "%d", &a) == 1 && a == 0);
+  CHECK (sscanf ("+7", "%u", &a) == 1 && a == 7);
+  CHECK (sscanf ("0x1F 017 0 99", "%i %i %i %hi", &a, &b, &n, &h) == 4);
+  CHECK (a == 31 && b == 15 && n == 0 && h == 99);
+  CHECK (sscanf ("ff 0XfF 777 1010", "%x %x %o %hd", &a, &b, &n, &h) == 4);
+  CHECK (a == 255 && b == 255 && n == 511 && h == 1010);
+  CHECK (sscanf ("12345", "%3d%d", &a, &b) == 2 && a == 123 && b == 45);
+  CHECK (sscanf ("70000", "%hd", &h) == 1 && h == (short) 70000);
+  CHECK (sscanf ("000000000000000000000000000000000000000000000000042",
+		 "%d%n", &a, &n) == 1 && a == 42 && n == 51);
+
+  /* A 0x with no digits after it is a 0, and the x is left.  */
+  CHECK (sscanf ("0xg", "%x%c", &a, &c) == 2 && a == 0 && c == 'x');
+  CHECK (sscanf ("0x1", "%2x%s", &a, s) == 2 && a == 0);
+  CHECK (strcmp (s, "x1") == 0);
+  CHECK (sscanf ("0x12", "%d%s", &a, s) == 2 && a == 0);
+  CHECK (strcmp (s, "x12") == 0);
+
+  /* A sign alone does not match.  */
+  CHECK (sscanf ("+z", "%d", &a) == 0);
+  CHECK (sscanf ("-", "%d", &a) == 0);
+  CHECK (sscanf ("x", "%d", &a) == 0);
+  CHECK (sscanf ("", "%d", &a) == EOF);
+
+  /* Out of range values are clamped as strtol and strtoul do.  */
+  errno = 0;
+  CHECK (sscanf ("99999999999999999999", "%ld", &l) == 1);
+  CHECK (l == LONG_MAX && errno == ERANGE);
+  errno = 0;
+  CHECK (sscanf ("-99999999999999999999", "%ld", &l) == 1);
+  CHECK (l == LONG_MIN && errno == ERANGE);
+  errno = 0;
+  CHECK (sscanf ("999999999999999999999", "%lu", &ul) == 1);
+  CHECK (ul == ULONG_MAX && errno == ERANGE);
+  errno = 0;
+  sprintf (t, "%ld %ld", LONG_MIN, LONG_MAX);
+  CHECK (sscanf (t, "%ld %lu", &l, &ul) == 2);
+  CHECK (l == LONG_MIN && ul == LONG_MAX && errno == 0);
+  CHECK (sscanf ("-1", "%lu", &ul) == 1 && ul == ULONG_MAX && errno == 0);
+
+  CHECK (sscanf ("0x1234abcd", "%p", &p) == 1 && p == (void *) 0x1234abcd);
+
+  CHECK (sscanf ("  word,tail  abcdefg", " %[a-z],%s %3c%n",
+		 s, t, t + 8, &n) == 3);
+  CHECK (strcmp (s, "word") == 0 && strcmp (t, "tail") == 0 && n == 16);
+  CHECK (memcmp (t + 8, "abc", 3) == 0);
+  CHECK (sscanf ("abc def", "%*s %2s", s) == 1 && strcmp (s, "de") == 0);
+  CHECK (sscanf (",", "%[a-z]", s) == 0);
+
+  fp = slow ("  123 -0x1f abc 0xg  word,tail 99999999999999999999");
+  CHECK (fp != NULL);
+  CHECK (fscanf (fp, "%d %i %s %x%c", &a, &b, s, &n, &c) == 5);
+  CHECK (a == 123 && b == -31 && strcmp (s, "abc") == 0);
+  CHECK (n == 0 && c == 'x');
+  CHECK (fscanf (fp, "%*c %[a-z],%3s", s, t) == 2);
+  CHECK (strcmp (s, "word") == 0 && strcmp (t, "tai") == 0);
+  errno = 0;
+  CHECK (fscanf (fp, "%*c %ld", &l) == 1 && l == LONG_MAX);
+  CHECK (errno == ERANGE);
+  CHECK (fscanf (fp, "%d", &a) == EOF);
+  fclose (fp);
+
+  return 0;
+}
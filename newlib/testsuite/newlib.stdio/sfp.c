@@ -0,0 +1,142 @@
+/* Check that many streams can be opened, closed and reopened, that
+   every open stream gets its own FILE, and that fflush (NULL) still
+   reaches the files among them.  The standard streams of another reent
+   are never handed out by fopen and friends, even once closed.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <reent.h>
+#include "check.h"
+
+#define N 500
+
+static int written[N];
+
+static int
+wr (void *cookie, const char *buf, int n)
+{
+  written[(long) cookie] += n;
+  return n;
+}
+
+/* Every 50th stream is a file, the others write to written[].  */
+static FILE *
+open (long i)
+{
+  char name[16];
+
+  if (i % 50 != 0)
+    return funopen ((void *) i, NULL, wr, NULL, NULL);
+  sprintf (name, "sfp%ld.tmp", i);
+  return fopen (name, "a");
+}
+
+/* Return the size of the file of stream I.  */
+static long
+size (long i)
+{
+  char name[16];
+  FILE *fp;
+  long n;
+
+  sprintf (name, "sfp%ld.tmp", i);
+  fp = fopen (name, "r");
+  if (fp == NULL)
+    return -1;
+  for (n = 0; getc (fp) != EOF; n++)
+    ;
+  fclose (fp);
+  return n;
+}
+
+static int
+nglue (void)
+{
+  struct _glue *g;
+  int n = 0;
+
+  for (g = &_GLOBAL_REENT->__sglue; g != NULL; g = g->_next)
+    n++;
+  return n;
+}
+
+int
+main (void)
+{
+  static FILE *fp[N];
+  static struct _reent r2;
+  FILE *f2;
+  char name[16];
+  int i, j, n;
+
+  for (i = 0; i < N; i++)
+    {
+      fp[i] = open (i);
+      CHECK (fp[i] != NULL);
+      for (j = 0; j < i; j++)
+	CHECK (fp[j] != fp[i]);
+    }
+  /* Growing the table geometrically needs few blocks.  */
+  CHECK (nglue () < 16);
+
+  for (i = 0; i < N; i++)
+    fputc ('x', fp[i]);
+  CHECK (fflush (NULL) == 0);
+  for (i = 0; i < N; i += 50)
+    CHECK (size (i) == 1);
+
+  /* Closed FILEs are reused, and no two open streams share one.  */
+  srand (1);
+  n = nglue ();
+  for (i = 0; i < 10 * N; i++)
+    {
+      j = rand () % N;
+      CHECK (fclose (fp[j]) == 0);
+      fp[j] = open (j);
+      CHECK (fp[j] != NULL);
+    }
+  for (i = 0; i < N; i += 2)
+    CHECK (fclose (fp[i]) == 0);
+  for (i = 0; i < N; i += 2)
+    CHECK ((fp[i] = open (i)) != NULL);
+  for (i = 0; i < N; i++)
+    for (j = 0; j < i; j++)
+      CHECK (fp[j] != fp[i]);
+  CHECK (nglue () == n);
+
+  /* A failed fopen gives its FILE back.  */
+  for (i = 0; i < 2 * N; i++)
+    CHECK (fopen ("does/not/exist", "r") == NULL);
+  CHECK (nglue () == n);
+
+  /* A FILE closed last is the first one reused, unless it belongs to
+     another reent.  */
+  _REENT_INIT_PTR (&r2);
+  f2 = r2._stdin;
+  CHECK (fclose (fp[1]) == 0);
+  CHECK (_fclose_r (&r2, f2) == 0);
+  CHECK ((fp[1] = open (1)) != NULL);
+  CHECK (fp[1] != f2);
+  _reclaim_reent (&r2);
+
+  for (i = 0; i < N; i++)
+    fputc ('y', fp[i]);
+  CHECK (fflush (NULL) == 0);
+  for (i = 0; i < N; i += 50)
+    CHECK (size (i) == 2);
+  for (i = 0; i < N; i++)
+    {
+      CHECK (fclose (fp[i]) == 0);
+      if (i % 50 != 0)
+	{
+	  CHECK (written[i] == 2);
+	}
+      else
+	{
+	  CHECK (size (i) == 2);
+	  sprintf (name, "sfp%d.tmp", i);
+	  remove (name);
+	}
+    }
+  return 0;
+}
@@ -0,0 +1,66 @@
+/* Check that calloc returns cleared memory, both for recycled blocks
+   and for memory fresh from the system, and that it rejects sizes
+   whose product overflows.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include "check.h"
+
+static volatile size_t half = (size_t) -1 / 2 + 2;
+
+static void
+check_zero (const unsigned char *p, size_t size)
+{
+  size_t n;
+
+  for (n = 0; n < size; n++)
+    CHECK (p[n] == 0);
+}
+
+int
+main (void)
+{
+  unsigned char *p, *q;
+  size_t size;
+
+  /* Overflow.  */
+  errno = 0;
+  CHECK (calloc (half, 2) == NULL);
+  CHECK (errno == ENOMEM);
+  CHECK (calloc (1 << 16, 1 << 16) == NULL);
+
+  for (size = 8; size <= 256 * 1024; size *= 4)
+    {
+      /* Fresh memory.  */
+      p = calloc (size, 1);
+      CHECK (p != NULL);
+      check_zero (p, size);
+
+      /* Recycled memory, also partly recycled when followed by fresh
+	 memory.  */
+      memset (p, 0xa5, size);
+      free (p);
+      q = calloc (size / 4, 8);
+      CHECK (q != NULL);
+      check_zero (q, size * 2);
+      memset (q, 0x5a, size * 2);
+      free (q);
+    }
+
+  /* Memory given back to the system and obtained again.  */
+  p = malloc (64 * 1024);
+  CHECK (p != NULL);
+  memset (p, 0xa5, 64 * 1024);
+  free (p);
+  malloc_trim (0);
+  p = calloc (64, 1024);
+  CHECK (p != NULL);
+  check_zero (p, 64 * 1024);
+  free (p);
+
+  p = calloc (0, 10);
+  free (p);
+  return 0;
+}
@@ -0,0 +1,87 @@
+/* Check that mallinfo agrees with a walk of the heap by malloc_walk.  */
+
+#include <stdlib.h>
+#include <malloc.h>
+#include "check.h"
+
+struct totals
+{
+  size_t used, free, total;
+  int nfree, nused;
+};
+
+static int
+count_chunk (void *p, size_t size, int used, void *arg)
+{
+  struct totals *t = arg;
+
+  CHECK (p != NULL && size > 0);
+  t->total += size;
+  if (used)
+    {
+      t->used += size;
+      t->nused++;
+    }
+  else
+    {
+      t->free += size;
+      t->nfree++;
+    }
+  return 0;
+}
+
+static int
+stop_walk (void *p, size_t size, int used, void *arg)
+{
+  ++*(int *) arg;
+  return 42;
+}
+
+static void
+check_heap (int min_used)
+{
+  struct mallinfo mi;
+  struct totals t = { 0, 0, 0, 0, 0 };
+
+  CHECK (malloc_walk (count_chunk, &t) == 0);
+  mi = mallinfo ();
+  CHECK ((size_t) mi.arena == t.total);
+  CHECK ((size_t) mi.uordblks == t.used);
+  CHECK ((size_t) mi.fordblks == t.free);
+  CHECK (mi.ordblks == t.nfree);
+  CHECK (mi.keepcost <= mi.fordblks);
+  CHECK (t.nused >= min_used);
+}
+
+int
+main (void)
+{
+  void *p[32];
+  struct mallinfo before, after;
+  int i, calls = 0;
+
+  for (i = 0; i < 32; i++)
+    {
+      p[i] = malloc (16 + i * 24);
+      CHECK (p[i] != NULL);
+    }
+  check_heap (32);
+
+  before = mallinfo ();
+  for (i = 0; i < 32; i += 2)
+    free (p[i]);
+  after = mallinfo ();
+  CHECK (after.arena >= before.arena);
+  CHECK (after.fordblks > before.fordblks);
+  CHECK (after.uordblks < before.uordblks);
+  check_heap (16);
+
+  CHECK (malloc_walk (stop_walk, &calls) == 42);
+  CHECK (calls == 1);
+
+  for (i = 1; i < 32; i += 2)
+    free (p[i]);
+  check_heap (0);
+
+  return 0;
+}
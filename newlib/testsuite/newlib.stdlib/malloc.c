@@ -0,0 +1,116 @@
+/* Replay a pseudo-random trace of malloc/free/realloc/memalign calls and
+   check that no live block is overwritten by the allocator.  The sizes
+   are biased towards small blocks, so the trace exercises both the small
+   size-class bins and the address sorted free list when nano malloc is
+   configured with --enable-newlib-nano-malloc-bins.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include "check.h"
+
+#define SLOTS 64
+#define STEPS 20000
+
+static struct
+{
+  unsigned char *p;
+  size_t size;
+  unsigned char tag;
+} slot[SLOTS];
+
+static unsigned long seed = 1;
+
+static unsigned long
+next_rand (void)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) & 0x7fff;
+}
+
+static size_t
+next_size (void)
+{
+  unsigned long r = next_rand ();
+
+  if (r % 8 == 0)
+    return 256 + r % 4096;
+  return 1 + r % 120;
+}
+
+static void
+check_slot (int i)
+{
+  size_t n;
+
+  for (n = 0; n < slot[i].size; n++)
+    CHECK (slot[i].p[n] == slot[i].tag);
+}
+
+static void
+fill_slot (int i, unsigned char *p, size_t size)
+{
+  slot[i].p = p;
+  slot[i].size = size;
+  slot[i].tag = (unsigned char) (i + size);
+  memset (p, slot[i].tag, size);
+}
+
+int
+main (void)
+{
+  int step, i;
+
+  for (step = 0; step < STEPS; step++)
+    {
+      unsigned long op = next_rand ();
+      size_t size = next_size ();
+      unsigned char *p;
+      size_t n;
+
+      i = next_rand () % SLOTS;
+      if (slot[i].p != NULL)
+	{
+	  check_slot (i);
+	  if (op % 4 == 0)
+	    {
+	      /* Grow or shrink in place or by copy.  */
+	      p = realloc (slot[i].p, size);
+	      CHECK (p != NULL);
+	      for (n = 0; n < size && n < slot[i].size; n++)
+		CHECK (p[n] == slot[i].tag);
+	      fill_slot (i, p, size);
+	    }
+	  else
+	    {
+	      free (slot[i].p);
+	      slot[i].p = NULL;
+	    }
+	  continue;
+	}
+
+      if (op % 16 == 0)
+	{
+	  p = memalign (64, size);
+	  CHECK (p != NULL);
+	  CHECK (((unsigned long) p & 63) == 0);
+	}
+      else
+	{
+	  p = malloc (size);
+	  CHECK (p != NULL);
+	  CHECK (((unsigned long) p & 7) == 0);
+	}
+      CHECK (malloc_usable_size (p) >= size);
+      fill_slot (i, p, size);
+    }
+
+  for (i = 0; i < SLOTS; i++)
+    if (slot[i].p != NULL)
+      {
+	check_slot (i);
+	free (slot[i].p);
+      }
+
+  return 0;
+}
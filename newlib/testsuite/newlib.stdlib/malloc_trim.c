@@ -0,0 +1,72 @@
+/* Check that malloc_trim and the M_TRIM_THRESHOLD option of mallopt
+   give the free memory at the top of the heap back to the system, and
+   that the heap is still usable afterwards.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include "check.h"
+
+#define BIG (64 * 1024)
+
+int
+main (void)
+{
+  struct mallinfo before, after;
+  char *keep, *p;
+
+  keep = malloc (100);
+  CHECK (keep != NULL);
+  memset (keep, 1, 100);
+
+  /* Explicit trim.  */
+  p = malloc (BIG);
+  CHECK (p != NULL);
+  memset (p, 2, BIG);
+  free (p);
+  before = mallinfo ();
+  CHECK ((size_t) before.keepcost >= BIG);
+  CHECK (malloc_trim (0) == 1);
+  after = mallinfo ();
+  CHECK (before.arena - after.arena >= BIG);
+  CHECK (after.keepcost == 0);
+  CHECK (malloc_trim (0) == 0);
+
+  /* Trim keeping some pad.  */
+  p = malloc (BIG);
+  CHECK (p != NULL);
+  free (p);
+  CHECK (malloc_trim (4096) == 1);
+  after = mallinfo ();
+  CHECK (after.keepcost >= 4096 && after.keepcost < BIG);
+
+  /* Automatic trim on free.  */
+  CHECK (mallopt (M_TRIM_THRESHOLD, 16 * 1024) == 1);
+  CHECK (mallopt (M_TOP_PAD, 0) == 1);
+  p = malloc (BIG);
+  CHECK (p != NULL);
+  before = mallinfo ();
+  free (p);
+  after = mallinfo ();
+  CHECK (before.arena - after.arena >= BIG);
+
+  /* Small frees below the threshold are kept.  */
+  p = malloc (1024);
+  CHECK (p != NULL);
+  before = mallinfo ();
+  free (p);
+  after = mallinfo ();
+  CHECK (after.arena == before.arena);
+  CHECK (mallopt (M_TRIM_THRESHOLD, 0) == 1);
+
+  /* The heap is still usable.  */
+  p = malloc (BIG);
+  CHECK (p != NULL);
+  memset (p, 3, BIG);
+  free (p);
+  for (p = keep; p < keep + 100; p++)
+    CHECK (*p == 1);
+  free (keep);
+
+  return 0;
+}
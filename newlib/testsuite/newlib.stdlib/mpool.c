@@ -0,0 +1,104 @@
+/* Check the fixed-size object pools of malloc.h, both from a caller
+   buffer and growing with malloc, and the tsearch trees built on them,
+   whose node pool lasts until tdestroy.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <search.h>
+#include "check.h"
+
+#define OBJ 20
+#define N 10
+
+static double buf[N * MALLOC_POOL_OBJSIZE (OBJ) / sizeof (double)];
+
+static int
+cmp (const void *a, const void *b)
+{
+  return *(const int *) a - *(const int *) b;
+}
+
+static void
+nofree (void *key)
+{
+}
+
+int
+main (void)
+{
+  struct malloc_pool pool;
+  char *p[3 * N];
+  int keys[100];
+  void *root = NULL;
+  int i, j, used;
+
+  /* Caller buffer: exactly N objects, handed out in address order.  */
+  malloc_pool_init (&pool, OBJ, buf, N);
+  CHECK (pool.nobjs == N && pool.nused == 0);
+  for (i = 0; i < N; i++)
+    {
+      p[i] = malloc_pool_alloc (&pool);
+      CHECK (p[i] == (char *) buf + i * MALLOC_POOL_OBJSIZE (OBJ));
+      memset (p[i], i, OBJ);
+    }
+  CHECK (malloc_pool_alloc (&pool) == NULL);
+  CHECK (pool.nused == N && pool.maxused == N);
+  malloc_pool_free (&pool, p[3]);
+  CHECK (malloc_pool_alloc (&pool) == p[3]);
+  for (i = 0; i < N; i++)
+    malloc_pool_free (&pool, p[i]);
+  CHECK (pool.nused == 0 && pool.maxused == N);
+
+  /* Growing pool: no object overlaps another.  */
+  malloc_pool_init (&pool, OBJ, NULL, 4);
+  CHECK (pool.nobjs == 0);
+  for (i = 0; i < 3 * N; i++)
+    {
+      p[i] = malloc_pool_alloc (&pool);
+      CHECK (p[i] != NULL);
+      memset (p[i], i, OBJ);
+    }
+  CHECK (pool.nobjs >= 3 * N && pool.nused == 3 * N);
+  for (i = 0; i < 3 * N; i++)
+    for (j = 0; j < OBJ; j++)
+      CHECK (p[i][j] == i);
+  for (i = 0; i < 3 * N; i += 2)
+    malloc_pool_free (&pool, p[i]);
+  CHECK (pool.nused == 3 * N / 2);
+  malloc_pool_destroy (&pool);
+  CHECK (pool.nobjs == 0 && pool.nused == 0);
+  CHECK (malloc_pool_alloc (&pool) != NULL);
+  malloc_pool_destroy (&pool);
+
+  /* tsearch nodes come from a pool.  */
+  for (i = 0; i < 100; i++)
+    {
+      keys[i] = (i * 37) % 100;
+      CHECK (tsearch (&keys[i], &root, cmp) != NULL);
+    }
+  for (i = 0; i < 100; i++)
+    CHECK (*(int *) *(void **) tfind (&i, &root, cmp) == i);
+  for (i = 0; i < 100; i += 2)
+    CHECK (tdelete (&i, &root, cmp) != NULL);
+  for (i = 0; i < 100; i++)
+    CHECK ((tfind (&i, &root, cmp) != NULL) == (i & 1));
+  for (i = 1; i < 100; i += 2)
+    CHECK (tdelete (&i, &root, cmp) != NULL);
+  CHECK (root == NULL);
+
+  /* The node pool outlives an empty tree, so a tree going between no
+     node and one does not allocate every time, until tdestroy.  */
+  CHECK (tsearch (&keys[0], &root, cmp) != NULL);
+  used = mallinfo ().uordblks;
+  for (i = 0; i < 100; i++)
+    {
+      CHECK (tdelete (&keys[0], &root, cmp) != NULL);
+      CHECK (mallinfo ().uordblks == used);
+      CHECK (tsearch (&keys[0], &root, cmp) != NULL);
+    }
+  tdestroy (root, nofree);
+  CHECK (mallinfo ().uordblks < used);
+
+  return 0;
+}
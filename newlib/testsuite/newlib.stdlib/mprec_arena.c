@@ -0,0 +1,68 @@
+/* Check that with enable-newlib-nano-mprec-arena, float conversions do
+   not use the heap, both with the static arena of the global reent and
+   with an arena given to another reent, and that they still work when
+   the arena is too small.  */
+
+#include <newlib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <reent.h>
+#include "check.h"
+
+asm (".global _printf_float");
+
+#ifdef _NANO_MPREC_ARENA
+static double stack_arena[4096 / sizeof (double)];
+
+static void
+convert (struct _reent *r, int prec)
+{
+  char buf[512];
+  double d;
+
+  _snprintf_r (r, buf, sizeof (buf), "%.*e %.*f", prec, 1.7976931348623157e308,
+	       prec, 2.2250738585072014e-308);
+  d = _strtod_r (r, "1.2345678901234567890123456789012345678e-307", NULL);
+  CHECK (d == 1.2345678901234567890123456789012345678e-307);
+  _snprintf_r (r, buf, sizeof (buf), "%.17g", 0.1);
+  CHECK (strcmp (buf, "0.10000000000000001") == 0);
+  CHECK (_strtod_r (r, buf, NULL) == 0.1);
+}
+#endif
+
+int
+main (void)
+{
+#ifdef _NANO_MPREC_ARENA
+  struct mallinfo before, after;
+  struct _reent r;
+  char small[64];
+  int prec;
+
+  before = mallinfo ();
+  for (prec = 0; prec <= 40; prec++)
+    convert (_REENT, prec);
+  after = mallinfo ();
+  CHECK (after.uordblks == before.uordblks);
+
+  _REENT_INIT_PTR (&r);
+  _mprec_arena_r (&r, stack_arena, sizeof (stack_arena));
+  for (prec = 0; prec <= 40; prec++)
+    convert (&r, prec);
+  _reclaim_reent (&r);
+  after = mallinfo ();
+  CHECK (after.uordblks == before.uordblks);
+
+  /* Beyond the arena, the numbers come from the heap.  */
+  _REENT_INIT_PTR (&r);
+  _mprec_arena_r (&r, small, sizeof (small));
+  convert (&r, 40);
+  _reclaim_reent (&r);
+  after = mallinfo ();
+  CHECK (after.uordblks == before.uordblks);
+#endif
+
+  return 0;
+}
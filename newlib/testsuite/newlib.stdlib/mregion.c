@@ -0,0 +1,93 @@
+/* Check that memory given to malloc_add_region is used by malloc_region
+   and free, and that the heap walk still covers every region.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <malloc.h>
+#include "check.h"
+
+/* Two banks with a gap in between.  */
+static double banks[16384 / sizeof (double)];
+#define bank1 ((char *) banks)
+#define bank2 ((char *) banks + 8192)
+#define BANK1_SIZE 4096
+#define BANK2_SIZE 8192
+
+#define IN(p, bank, size) \
+  ((char *) (p) >= (bank) && (char *) (p) < (bank) + (size))
+
+static size_t walked;
+
+static int
+count_chunk (void *p, size_t size, int used, void *arg)
+{
+  walked += size;
+  return 0;
+}
+
+int
+main (void)
+{
+  struct mallinfo before, after;
+  void *p[64];
+  int r1, r2, i, n;
+
+  before = mallinfo ();
+  r1 = malloc_add_region (bank1, BANK1_SIZE);
+  r2 = malloc_add_region (bank2, BANK2_SIZE);
+  CHECK (r1 >= 0 && r2 >= 0 && r1 != r2);
+  after = mallinfo ();
+  CHECK (after.arena - before.arena == BANK1_SIZE + BANK2_SIZE);
+
+  /* Overlapping and too small regions are refused.  */
+  errno = 0;
+  CHECK (malloc_add_region (bank1 + 64, 256) == -1);
+  CHECK (errno == EINVAL);
+  CHECK (malloc_add_region (bank1, 1) == -1);
+  CHECK (malloc_region (99, 16) == NULL);
+
+  /* Allocations stay in their region until it is full.  */
+  for (n = 0; n < 64; n++)
+    {
+      p[n] = malloc_region (r1, 200);
+      if (p[n] == NULL)
+	break;
+      CHECK (IN (p[n], bank1, BANK1_SIZE));
+      CHECK (((unsigned long) p[n] & 7) == 0);
+      memset (p[n], n, 200);
+    }
+  CHECK (n >= 10 && n < 64);
+  CHECK (errno == ENOMEM);
+  for (i = 0; i < n; i += 2)
+    free (p[i]);
+  for (i = 0; i < n; i += 2)
+    {
+      p[i] = malloc_region (r1, 150);
+      CHECK (IN (p[i], bank1, BANK1_SIZE));
+    }
+  for (i = 1; i < n; i += 2)
+    CHECK (((unsigned char *) p[i])[199] == i);
+
+  p[n] = malloc_region (r2, 5000);
+  CHECK (IN (p[n], bank2, BANK2_SIZE));
+
+  walked = 0;
+  CHECK (malloc_walk (count_chunk, NULL) == 0);
+  after = mallinfo ();
+  CHECK ((size_t) after.arena == walked);
+
+  for (i = 0; i <= n; i++)
+    free (p[i]);
+
+  /* Memory next to a region joins it.  */
+  CHECK (malloc_add_region (bank1 + BANK1_SIZE, 1024) == r1);
+  p[0] = malloc_region (r1, BANK1_SIZE);
+  CHECK (IN (p[0], bank1, BANK1_SIZE + 1024));
+  free (p[0]);
+  walked = 0;
+  CHECK (malloc_walk (count_chunk, NULL) == 0);
+  CHECK ((size_t) mallinfo ().arena == walked);
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* Check that realloc keeps the contents when it grows and shrinks a
+   block, and that it does so in place when it can: a block followed by
+   free memory or by the top of the heap grows without moving, and a
+   shrunk block gives its tail back.  If something else has moved the
+   break, realloc has to copy, and the memory it took from sbrk in the
+   meantime must still make a valid free chunk.  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <unistd.h>
+#include "check.h"
+
+static void
+check_fill (unsigned char *p, size_t size, unsigned char tag)
+{
+  size_t n;
+
+  for (n = 0; n < size; n++)
+    CHECK (p[n] == (unsigned char) (tag + n));
+}
+
+static void
+fill (unsigned char *p, size_t from, size_t size, unsigned char tag)
+{
+  size_t n;
+
+  for (n = from; n < size; n++)
+    p[n] = (unsigned char) (tag + n);
+}
+
+int
+main (void)
+{
+  unsigned char *p, *q, *r;
+  size_t size, usable;
+  int moves = 0, steps = 0;
+
+  /* A few bytes more than the top block has, after the break moved.  */
+  p = malloc (100);
+  CHECK (p != NULL);
+  fill (p, 0, 100, 3);
+  CHECK (sbrk (64) != (void *) -1);
+  q = realloc (p, 108);
+  CHECK (q != NULL);
+  check_fill (q, 100, 3);
+  r = malloc (8);
+  CHECK (r != NULL);
+  free (r);
+  free (q);
+
+  /* Geometric growth.  */
+  p = malloc (16);
+  CHECK (p != NULL);
+  fill (p, 0, 16, 1);
+  for (size = 32; size <= 64 * 1024; size *= 2)
+    {
+      q = realloc (p, size);
+      CHECK (q != NULL);
+      check_fill (q, size / 2, 1);
+      fill (q, size / 2, size, 1);
+      moves += q != p;
+      steps++;
+      p = q;
+    }
+  CHECK (moves < steps / 2);
+
+  /* Shrinking keeps the block and gives the tail back.  */
+  usable = malloc_usable_size (p);
+  q = realloc (p, 100);
+  CHECK (q == p);
+  CHECK (malloc_usable_size (q) < usable);
+  check_fill (q, 100, 1);
+
+  /* The freed tail can be grown into again.  */
+  r = realloc (q, 4000);
+  CHECK (r == q);
+  check_fill (r, 100, 1);
+  fill (r, 100, 4000, 1);
+
+  /* Growing into a free neighbour.  */
+  p = malloc (200);
+  q = malloc (1000);
+  r = malloc (16);
+  CHECK (p != NULL && q != NULL && r != NULL);
+  fill (p, 0, 200, 7);
+  free (q);
+  q = realloc (p, 600);
+  CHECK (q != NULL);
+  check_fill (q, 200, 7);
+  free (q);
+  free (r);
+
+  /* Zero size frees, NULL pointer allocates.  */
+  p = realloc (NULL, 10);
+  CHECK (p != NULL);
+  CHECK (realloc (p, 0) == NULL);
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+/* Compare memmove, memset, memcmp and memchr with plain byte loops,
+   for all sizes up to MAX.  memmove is tried with the destination at
+   every distance from the source that overlaps it, both ways, and
+   some that do not; the others with every alignment up to ALIGN and,
+   for memcmp and memchr, the byte in question at every position.  */
+
+#define MAX 300
+#define ALIGN 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOO_MANY_ERRORS 11
+int errors = 0;
+
+#define DEBUGP					\
+ if (errors == TOO_MANY_ERRORS)			\
+   printf ("Further errors omitted\n");		\
+ else if (errors < TOO_MANY_ERRORS)		\
+   printf
+
+/* Not a constant, to keep the compiler from warning about it.  */
+size_t endless = (size_t) -1;
+
+static unsigned char buf[ALIGN + 3 * MAX + ALIGN];
+static unsigned char known[sizeof (buf)];
+
+static void
+fill (unsigned char *p)
+{
+  size_t i;
+
+  for (i = 0; i < sizeof (buf); i++)
+    p[i] = i * 7 + i / 251;
+}
+
+static void
+mymemmove (unsigned char *dest, unsigned char *src, size_t n)
+{
+  if (src >= dest)
+    while (n-- > 0)
+      *dest++ = *src++;
+  else
+    {
+      dest += n;
+      src += n;
+      while (n-- > 0)
+	*--dest = *--src;
+    }
+}
+
+static int
+sign (int n)
+{
+  return n < 0 ? -1 : n > 0;
+}
+
+static int
+mymemcmp (const unsigned char *s1, const unsigned char *s2, size_t n)
+{
+  for (; n > 0; n--, s1++, s2++)
+    if (*s1 != *s2)
+      return *s1 - *s2;
+  return 0;
+}
+
+static void
+test_memmove (void)
+{
+  unsigned char *src;
+  void *ret;
+  int n, d;
+
+  for (n = 0; n <= MAX; n++)
+    for (d = -n - 1; d <= n + 1; d++)
+      {
+	src = buf + ALIGN + MAX + (n + d) % 16;
+	fill (buf);
+	ret = memmove (src + d, src, n);
+	fill (known);
+	mymemmove (known + (src - buf) + d, known + (src - buf), n);
+	if (ret != src + d || memcmp (buf, known, sizeof (buf)) != 0)
+	  {
+	    errors++;
+	    DEBUGP ("memmove failed for %d bytes to %d bytes away\n", n, d);
+	  }
+      }
+}
+
+static void
+test_memset (void)
+{
+  unsigned char *p;
+  void *ret;
+  int n, al, c, i;
+
+  for (n = 0; n <= MAX; n++)
+    for (al = 0; al < ALIGN; al++)
+      {
+	c = (n + al) % 2 ? 0x80 + al : al;
+	p = buf + ALIGN + al;
+	fill (buf);
+	ret = memset (p, c + 0x100, n);
+	fill (known);
+	for (i = 0; i < n; i++)
+	  known[ALIGN + al + i] = c;
+	if (ret != p || memcmp (buf, known, sizeof (buf)) != 0)
+	  {
+	    errors++;
+	    DEBUGP ("memset failed for %d bytes at %d\n", n, al);
+	  }
+      }
+}
+
+static void
+test_memcmp (void)
+{
+  unsigned char *s1, *s2;
+  int n, al, pos, r;
+
+  fill (buf);
+  for (n = 0; n <= MAX; n++)
+    for (al = 0; al < ALIGN; al += 3)
+      {
+	s1 = buf + al;
+	s2 = buf + ALIGN + MAX + (n + al) % ALIGN;
+	memcpy (s2, s1, n);
+	if (memcmp (s1, s2, n) != 0)
+	  {
+	    errors++;
+	    DEBUGP ("memcmp failed for %d equal bytes at %d\n", n, al);
+	  }
+	for (pos = 0; pos < n; pos++)
+	  {
+	    s2[pos] ^= (pos & 1) ? 0x80 : 0x01;
+	    if (sign (r = memcmp (s1, s2, n)) != sign (mymemcmp (s1, s2, n))
+		|| sign (memcmp (s2, s1, n)) != -sign (r))
+	      {
+		errors++;
+		DEBUGP ("memcmp failed for %d bytes at %d, differing at %d\n",
+			n, al, pos);
+	      }
+	    s2[pos] = s1[pos];
+	  }
+      }
+}
+
+static void
+test_memchr (void)
+{
+  unsigned char *p;
+  int n, al, pos;
+
+  for (n = 0; n <= MAX; n++)
+    for (al = 0; al < ALIGN; al++)
+      {
+	p = buf + ALIGN + al;
+	memset (buf, 'a', sizeof (buf));
+	if (memchr (p, 'b', n) != NULL)
+	  {
+	    errors++;
+	    DEBUGP ("memchr found what is not in %d bytes at %d\n", n, al);
+	  }
+	/* Just outside the block.  */
+	p[-1] = p[n] = 'b';
+	if (memchr (p, 'b', n) != NULL)
+	  {
+	    errors++;
+	    DEBUGP ("memchr looked outside %d bytes at %d\n", n, al);
+	  }
+	for (pos = n - 1; pos >= 0; pos -= 1 + pos / 16)
+	  {
+	    p[pos] = 0xb0;
+	    if (memchr (p, 0xb0 - 0x100, n) != p + pos)
+	      {
+		errors++;
+		DEBUGP ("memchr failed for %d bytes at %d, at %d\n",
+			n, al, pos);
+	      }
+	  }
+	/* A length running beyond the end of memory.  */
+	if (memchr (p, 'b', endless) != p + n)
+	  {
+	    errors++;
+	    DEBUGP ("memchr failed for endless block at %d\n", al);
+	  }
+      }
+}
+
+int
+main (void)
+{
+  test_memmove ();
+  test_memset ();
+  test_memcmp ();
+  test_memchr ();
+
+  if (errors != 0)
+    abort ();
+  exit (0);
+}
@@ -0,0 +1,169 @@
+/* Compare strlen, strchr and strcmp with plain byte loops, for all
+   alignments of the strings up to 64 and lengths up to MAX, and for
+   random strings.  Machine versions look at many bytes at a time, so
+   the interesting cases are ends of strings and differences at every
+   position of a vector, and strings starting anywhere in one.  */
+
+#define MAX 300
+#define ALIGN 64
+#define RANDOM 20000
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TOO_MANY_ERRORS 11
+int errors = 0;
+
+#define DEBUGP					\
+ if (errors == TOO_MANY_ERRORS)			\
+   printf ("Further errors omitted\n");		\
+ else if (errors < TOO_MANY_ERRORS)		\
+   printf
+
+static unsigned long seed = 1;
+
+static int
+rnd (int n)
+{
+  seed = seed * 1103515245 + 12345;
+  return (seed >> 16) % n;
+}
+
+static size_t
+mystrlen (const char *s)
+{
+  size_t n = 0;
+
+  while (s[n] != '\0')
+    n++;
+  return n;
+}
+
+static char *
+mystrchr (const char *s, int c)
+{
+  for (;; s++)
+    {
+      if (*s == (char) c)
+	return (char *) s;
+      if (*s == '\0')
+	return NULL;
+    }
+}
+
+static int
+mystrcmp (const char *s1, const char *s2)
+{
+  const unsigned char *p1 = (const unsigned char *) s1;
+  const unsigned char *p2 = (const unsigned char *) s2;
+
+  while (*p1 != '\0' && *p1 == *p2)
+    p1++, p2++;
+  return *p1 - *p2;
+}
+
+static int
+sign (int n)
+{
+  return n < 0 ? -1 : n > 0;
+}
+
+static char buf1[ALIGN + MAX + ALIGN];
+static char buf2[ALIGN + MAX + ALIGN];
+
+/* Put LEN bytes of nonzero junk and a NUL at BUF + AL, and junk after
+   the NUL, with some bytes of the high half.  */
+static char *
+fill (char *buf, int al, int len)
+{
+  int i;
+
+  for (i = 0; i < (int) sizeof (buf1); i++)
+    buf[i] = 1 + rnd (255);
+  buf[al + len] = '\0';
+  return buf + al;
+}
+
+static void
+check (char *s1, char *s2, int c)
+{
+  char *r;
+  int n;
+
+  if (strlen (s1) != mystrlen (s1))
+    {
+      errors++;
+      DEBUGP ("strlen failed for length %d at %p\n",
+	      (int) mystrlen (s1), s1);
+    }
+  if ((r = strchr (s1, c)) != mystrchr (s1, c))
+    {
+      errors++;
+      DEBUGP ("strchr failed for %d in length %d at %p, gave %p\n",
+	      c, (int) mystrlen (s1), s1, r);
+    }
+  if (sign (n = strcmp (s1, s2)) != sign (mystrcmp (s1, s2)))
+    {
+      errors++;
+      DEBUGP ("strcmp failed for lengths %d, %d at %p, %p, gave %d\n",
+	      (int) mystrlen (s1), (int) mystrlen (s2), s1, s2, n);
+    }
+}
+
+int
+main (void)
+{
+  char *s1, *s2;
+  int al1, al2, len, i, pos;
+
+  for (al1 = 0; al1 < ALIGN; al1++)
+    for (len = 0; len < MAX; len++)
+      {
+	al2 = (al1 * 7 + len) % ALIGN;
+	s1 = fill (buf1, al1, len);
+	s2 = buf2 + al2;
+	memcpy (s2, s1, len + 1);
+
+	/* Equal strings, looking for a byte of them, for a byte that
+	   is not there and for the NUL.  */
+	check (s1, s2, len > 0 ? s1[rnd (len)] : 'a');
+	check (s1, s2, 0);
+	for (i = 0; i < len; i++)
+	  if (s1[i] == 'x')
+	    s1[i] = s2[i] = 'y';
+	check (s1, s2, 'x');
+
+	/* A difference at every position, either way.  */
+	for (pos = 0; pos <= len; pos += 1 + rnd (3))
+	  {
+	    s2[pos] = s1[pos] + 1;
+	    check (s1, s2, s1[pos]);
+	    check (s2, s1, s1[pos]);
+	    s2[pos] = s1[pos];
+	  }
+
+	/* One string a prefix of the other.  */
+	if (len > 0)
+	  {
+	    s2[len - 1] = '\0';
+	    check (s1, s2, 0);
+	    check (s2, s1, 0);
+	  }
+      }
+
+  for (i = 0; i < RANDOM; i++)
+    {
+      len = rnd (MAX);
+      s1 = fill (buf1, rnd (ALIGN), len);
+      s2 = fill (buf2, rnd (ALIGN), rnd (MAX));
+      if (rnd (2))
+	memcpy (s2, s1, rnd (len + 1));
+      check (s1, s2, rnd (256));
+      check (s2, s1, s1[rnd (len + 1)]);
+    }
+
+  if (errors != 0)
+    abort ();
+  exit (0);
+}
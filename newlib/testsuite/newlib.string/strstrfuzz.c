@@ -0,0 +1,115 @@
+/* Compare strstr, memmem and strcasestr with plain quadratic searches,
+   for haystacks of up to MAX bytes and needles of up to NEEDLE bytes
+   made of a few letters, so that partial matches are frequent.  The
+   needles are cut from the haystack or made up, and the haystacks are
+   periodic or random.  */
+
+#define MAX 200
+#define NEEDLE 40
+#define ROUNDS 40
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define TOO_MANY_ERRORS 11
+int errors = 0;
+
+#define DEBUGP					\
+ if (errors == TOO_MANY_ERRORS)			\
+   printf ("Further errors omitted\n");		\
+ else if (errors < TOO_MANY_ERRORS)		\
+   printf
+
+static char hay[MAX + 1];
+static char needle[NEEDLE + 1];
+
+static char *
+mystrstr (const char *h, const char *n, int fold)
+{
+  size_t i;
+
+  for (;; h++)
+    {
+      for (i = 0; n[i] != '\0'; i++)
+	if (fold ? (tolower ((unsigned char) h[i])
+		    != tolower ((unsigned char) n[i]))
+	    : h[i] != n[i])
+	  break;
+      if (n[i] == '\0')
+	return (char *) h;
+      if (*h == '\0')
+	return NULL;
+    }
+}
+
+static void
+check (int hlen, int nlen)
+{
+  char *want;
+  void *got;
+
+  want = mystrstr (hay, needle, 0);
+  if ((got = strstr (hay, needle)) != want)
+    {
+      errors++;
+      DEBUGP ("strstr (\"%s\", \"%s\") returned %d\n", hay, needle,
+	      got ? (int) ((char *) got - hay) : -1);
+    }
+  if ((got = memmem (hay, hlen, needle, nlen)) != want)
+    {
+      errors++;
+      DEBUGP ("memmem (\"%s\", \"%s\") returned %d\n", hay, needle,
+	      got ? (int) ((char *) got - hay) : -1);
+    }
+  want = mystrstr (hay, needle, 1);
+  if ((got = strcasestr (hay, needle)) != want)
+    {
+      errors++;
+      DEBUGP ("strcasestr (\"%s\", \"%s\") returned %d\n", hay, needle,
+	      got ? (int) ((char *) got - hay) : -1);
+    }
+}
+
+static void
+make (char *p, int n, int letters, int period)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    p[i] = (period && i >= period ? p[i - period]
+	    : "abAB"[rand () % letters]);
+  p[n] = '\0';
+}
+
+int
+main (void)
+{
+  int hlen, nlen, r, pos;
+
+  srand (1);
+  for (hlen = 0; hlen <= MAX; hlen += 1 + hlen / 16)
+    for (nlen = 1; nlen <= NEEDLE; nlen++)
+      for (r = 0; r < ROUNDS; r++)
+	{
+	  make (hay, hlen, 2 + r % 3, r % 4 ? 0 : 1 + r % 5);
+	  if (r % 2 && nlen <= hlen)
+	    {
+	      /* Cut from the haystack, perhaps with the last byte
+		 changed, so that it is found late or nearly found.  */
+	      pos = rand () % (hlen - nlen + 1);
+	      memcpy (needle, hay + pos, nlen);
+	      needle[nlen] = '\0';
+	      if (r % 3 == 0)
+		needle[nlen - 1] ^= 1;
+	    }
+	  else
+	    make (needle, nlen, 2 + r % 3, r % 8 ? 0 : 1 + r % 3);
+	  check (hlen, nlen);
+	}
+
+  if (errors != 0)
+    abort ();
+  exit (0);
+}